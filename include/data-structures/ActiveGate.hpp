@@ -4,25 +4,52 @@
 #include "Gate.hpp"
 #include "Point.hpp"
 #include "Matrix.hpp"
+#include "PathPool.hpp"
 #include "config.hpp"
 
+#include <memory_resource>
 #include <vector>
 
-struct ActiveGate : public Gate {
-    std::vector<Point> braidPath; // lattice resources occupied by this gate
+// a gate in flight; it keeps the gate's id and qubits but not its name, so activating a gate never allocates
+struct ActiveGate {
+    int id; // gate id in the DAG (-1 for SWAPs, which are not part of the circuit)
+    int control; // -1 for single-qubit gates
+    int target;
+
+    BraidPath braidPath; // lattice resources occupied by this gate (stored in a PathPool)
     int cycleCost; // how long gate will need to execute
 
-    int lifetime = 0; // how long gate has been active so far
+    int lifetime = 0; // how long gate has been active so far (negative while a reservation waits to start)
+    int finishCycle = 0; // cycle at which the gate completes (set by ActiveGateQueue, which does not tick lifetimes)
 };
 
+inline bool isSingle(const ActiveGate& g) { return g.control == -1; }
 inline bool isDone(const ActiveGate& g) { return g.lifetime >= g.cycleCost; }
 
 // occupy lattice resources and active gate (modifies world)
+// the resources are stored in 'paths'; release them there once the gate is done
 // d is the surface code distance
-ActiveGate activateGate(const Gate& g, std::vector<Point> resources, Matrix& world, const Environment& env);
-
-// free up resources taken by a gate that has completed
-void deactivateGate(const ActiveGate& g, Matrix& world);
+ActiveGate activateGate(
+    const Gate& g,
+    const std::pmr::vector<Point>& resources,
+    Matrix& world,
+    PathPool& paths,
+    const Environment& env
+);
+
+// reserve lattice resources for a gate that starts executing 'delay' cycles from now (modifies world)
+// the resources may still be taken by other gates, as long as those finish within 'delay' cycles
+ActiveGate reserveGate(
+    const Gate& g,
+    const std::pmr::vector<Point>& resources,
+    int delay,
+    Matrix& world,
+    PathPool& paths,
+    const Environment& env
+);
+
+// free up resources taken by a gate that has completed (does not release its path)
+void deactivateGate(const ActiveGate& g, Matrix& world, const PathPool& paths);
 
 // d is the surface code distance
 int getCost(const std::string& name, const Environment& env);
@@ -0,0 +1,57 @@
+#ifndef ACTIVE_GATE_QUEUE_HPP
+#define ACTIVE_GATE_QUEUE_HPP
+
+#include <list>
+#include <memory_resource>
+#include <queue>
+#include <vector>
+
+#include "ActiveGate.hpp"
+
+// gates in flight, listed most recently added first
+// each gate's absolute completion cycle is fixed when it is added, and a min-heap on it yields the
+// gates that finish next in O(log n), so lifetimes never need to be ticked forward
+// gates completing in the same cycle come out in list order
+// list nodes are recycled through a pool, so a steady stream of gates does not touch the global heap
+class ActiveGateQueue {
+public:
+    using const_iterator = std::pmr::list<ActiveGate>::const_iterator;
+
+    // add a gate at cycle 'now'; it has been running for g.lifetime cycles (negative if it starts later)
+    void push(ActiveGate g, int now);
+
+    // cycle at which the next gate completes (the queue must not be empty)
+    int nextCompletion() const { return heap.top().finishCycle; }
+
+    // is there a gate completing at or before cycle 'now'?
+    bool hasCompleted(int now) const { return !heap.empty() && heap.top().finishCycle <= now; }
+
+    // remove and return the next completed gate (hasCompleted() must hold)
+    ActiveGate popCompleted();
+
+    void clear();
+    bool empty() const { return gates.empty(); }
+    int size() const { return gates.size(); }
+
+    const_iterator begin() const { return gates.cbegin(); }
+    const_iterator end() const { return gates.cend(); }
+
+private:
+    struct Event {
+        int finishCycle;
+        unsigned long order; // gates added later complete first among equal finishCycles (list order)
+        std::pmr::list<ActiveGate>::iterator gate;
+
+        bool operator<(const Event& other) const { // reversed, since std::priority_queue is a max-heap
+            if(finishCycle != other.finishCycle) return finishCycle > other.finishCycle;
+            return order < other.order;
+        }
+    };
+
+    std::pmr::unsynchronized_pool_resource nodes; // must outlive 'gates'
+    std::pmr::list<ActiveGate> gates {&nodes};
+    std::priority_queue<Event, std::vector<Event>> heap;
+    unsigned long numPushed = 0;
+};
+
+#endif
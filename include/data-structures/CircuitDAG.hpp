@@ -1,6 +1,7 @@
 #ifndef CIRCUIT_DAG_HPP
 #define CIRCUIT_DAG_HPP
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -13,35 +14,68 @@ namespace detail {
         int controlChildId = -1, targetChildId = -1;
         int numDependencies = 0; // number of parent gates in DAG
         int numParentsFinished = 0;
-        bool finished = false; // used for asserts
-        
+
         GateNode(int id, std::string n, int c, int t) : g{id, n, c, t} {}
     };
 }
 
 // NOTE: no bounds checking is performed on GateNode ids!
+// gate ids are dense (0 to numGates()-1), so the state of every gate is kept in a byte per gate,
+// and the executable and active gates are also kept in compact lists for iteration
 class CircuitDAG {
 public:
     using GateNode = detail::GateNode;
 
+    // waiting -> executable (all parents finished) -> active (activateGate()) -> finished (resolveGate())
+    enum class GateState : unsigned char { waiting, executable, active, finished };
+
     CircuitDAG(std::string fname) : fileName(fname) {}
 
     const Gate& get(int id) const;
-    std::unordered_set<int> getExecutableGates() const { return canExecute; } // returns snapshot of CX layer
+    const GateNode& getNode(int id) const { return gateList[id]; }
+
+    GateState getState(int id) const { return states[id]; }
+    bool isExecutable(int id) const { return states[id] == GateState::executable; }
+    bool isActive(int id) const { return states[id] == GateState::active; }
+    bool isFinished(int id) const { return states[id] == GateState::finished; }
+
+    // the executable layer (in gate id order) and the gates in flight (in no particular order)
+    // both change as gates are activated and resolved, so iterate over a copy when doing so
+    const std::vector<int>& getExecutableGates() const { return executable; }
+    const std::vector<int>& getActiveGates() const { return active; }
 
     int numLogicalQubits() const { return numQubits; }
     int numGates() const { return gateList.size(); }
+    unsigned long getVersion() const { return version; } // changes whenever the executable layer changes
+
+    // earliest (ASAP) and latest (ALAP) start cycles of every gate when braiding resources are unlimited,
+    // with gate durations given by 'cost'; one forward and one backward pass over the gate list
+    // a gate's slack is how far it can be delayed without lengthening the critical path
+    void computeTiming(const std::function<int(const Gate&)>& cost);
+    bool hasTiming() const { return !asap.empty(); }
+    int getASAP(int id) const { return asap[id]; }
+    int getALAP(int id) const { return alap[id]; }
+    int getSlack(int id) const { return alap[id] - asap[id]; }
+    int getCriticalPathLength() const { return criticalPathLength; }
 
     void build();
-    void activateGate(int id); // mark gate as activated
-    void resolveGate(int id); // mark gate as completed and update canExecute
+    void activateGate(int id); // mark executable gate as activated
+    void resolveGate(int id); // mark gate as completed and update the executable layer
     void reset();
 
 private:
     std::string fileName;
     int numQubits = 0;
-    std::unordered_set<int> canExecute; // holds layer of gates which can execute concurrently
     std::vector<GateNode> gateList;
+    std::vector<GateState> states; // by gate id
+    std::vector<int> executable; // sorted by gate id
+    std::vector<int> active; // swap-with-last removal
+    std::vector<int> listPos; // position of each active gate in 'active'
+
+    void setState(int id, GateState state); // moves the gate between lists
+    std::vector<int> asap, alap; // start cycles by gate id (empty until computeTiming() is called)
+    int criticalPathLength = 0;
+    unsigned long version = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef CYCLE_ARENA_HPP
+#define CYCLE_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// bump allocator for temporaries that all die at the same time (eg once per scheduling cycle)
+// deallocation is a no-op; reset() frees everything at once but keeps the memory for reuse
+// if a cycle needed more than one chunk, reset() merges them into a single chunk of the combined size,
+// so once the arena has grown to the largest cycle seen it stops going to the global heap
+// not thread-safe
+class CycleArena : public std::pmr::memory_resource {
+public:
+    explicit CycleArena(std::size_t initialBytes = 1 << 16);
+
+    CycleArena(const CycleArena&) = delete;
+    CycleArena& operator=(const CycleArena&) = delete;
+
+    // invalidates everything allocated from the arena since the last reset
+    void reset();
+
+    std::size_t bytesUsed() const { return used + offset; } // allocated since the last reset
+    std::size_t capacity() const; // bytes held in all chunks
+    int numChunks() const { return chunks.size(); }
+
+private:
+    struct Chunk {
+        std::unique_ptr<std::byte[]> bytes;
+        std::size_t size;
+    };
+
+    std::vector<Chunk> chunks; // the last chunk is being carved
+    std::size_t offset = 0; // position in the last chunk
+    std::size_t used = 0; // bytes carved from the earlier chunks
+
+    void addChunk(std::size_t size);
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef FREE_SPACE_MAP_HPP
+#define FREE_SPACE_MAP_HPP
+
+#include <vector>
+
+#include "Point.hpp"
+#include "Matrix.hpp"
+
+// connected-component labelling of the free vertices of the lattice
+// used to reject braids whose endpoints cannot possibly be connected before running A*
+// labels are only recomputed after vertices have been freed: claiming vertices can only split
+// components, so a stale labelling never rejects a gate that could actually be braided
+class FreeSpaceMap {
+public:
+    FreeSpaceMap(int rows, int cols);
+
+    void invalidate() { dirty = true; } // call whenever vertices in 'world' are freed
+    void update(const Matrix& world); // relabel free vertices if the labelling is out of date
+
+    // returns false if no corner of 'source' shares a free component with a corner of 'dest'
+    bool mayConnect(const Cell& source, const Cell& dest) const;
+
+private:
+    Matrix labels; // 0 for occupied vertices, otherwise the component number
+    bool dirty = true;
+    std::vector<Point> stk; // scratch: flood fill stack (kept to avoid reallocating on every update)
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
+#include <memory_resource>
 #include <unordered_map>
 #include <vector>
 
@@ -8,10 +9,17 @@
 
 namespace detail {
     struct Vertex {
+        using allocator_type = std::pmr::polymorphic_allocator<int>; // neighbours live with the graph
+
         int id;
-        std::unordered_set<int> neighbours;
+        std::pmr::unordered_set<int> neighbours;
 
-        Vertex(int id) : id(id) {}
+        Vertex(int id, const allocator_type& alloc = {}) : id(id), neighbours(alloc) {}
+        Vertex(const Vertex& v, const allocator_type& alloc = {}) : id(v.id), neighbours(v.neighbours, alloc) {}
+        Vertex(Vertex&& v) = default;
+        Vertex(Vertex&& v, const allocator_type& alloc) : id(v.id), neighbours(std::move(v.neighbours), alloc) {}
+        Vertex& operator=(const Vertex&) = default;
+        Vertex& operator=(Vertex&&) = default;
 
         int degree() const { return neighbours.size(); }
     };
@@ -23,11 +31,15 @@ public:
     using Vertex = detail::Vertex;
     struct const_iterator; // read-only forward iterator wrapping underlying map iterator
 
-    using vertex_list = std::unordered_map<int, Vertex>;
+    using vertex_list = std::pmr::unordered_map<int, Vertex>;
+
+    // vertices and their neighbour sets are allocated from 'memory'
+    explicit Graph(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) : graph(memory) {}
 
     void addVertex(int id);
     void deleteVertex(int id); // assumes id is present in the graph
     void addEdge(int id1, int id2); // assumes id1 and id2 are already present in the graph
+    void deleteEdge(int id1, int id2); // assumes id1 and id2 are present in the graph
 
     const Vertex& getVertex(int id) const { return graph.at(id); }
     int numVertices() const { return graph.size(); }
@@ -0,0 +1,38 @@
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include <vector>
+
+#include "Point.hpp"
+#include "ReservationTable.hpp"
+
+// landmark distance fields for the ALT (A*, landmarks, triangle inequality) heuristic
+// distances are computed by BFS over the vertices that are free by cycle 'until' (see compute()).
+// until then, the free space can only be a subset of that graph, so true distances can only be longer
+// and the estimates stay admissible (and consistent) no matter how many vertices become occupied
+class Landmarks {
+public:
+    static constexpr int unreachable = -1; // estimate() result when no path to 'dest' can exist
+
+    Landmarks(int rows, int cols, int count);
+
+    // recompute distance fields over the vertices whose claims expire by cycle 'until'
+    void compute(const ReservationTable& table, int until);
+    void invalidate() { validUntil = -1; } // call when claims are dropped early (eg 'world' is cleared)
+    bool isValid(int now) const { return now <= validUntil; }
+
+    // lower bound on the length of a path from 'v' to the nearest corner of 'dest'
+    int estimate(const Point& v, const Cell& dest) const;
+
+private:
+    int rows, cols;
+    int count; // number of landmarks
+    std::vector<int> dist; // dist[l*rows*cols + v]: BFS distance from landmark l to vertex v (-1 if unreached)
+    int validUntil = -1;
+
+    // scratch space for compute(), kept so that recomputing does not allocate
+    std::vector<int> nearest; // distance from each vertex to the nearest landmark chosen so far
+    std::vector<int> queue; // BFS queue
+};
+
+#endif
@@ -15,6 +15,7 @@ public:
     void setMapping(std::vector<int> mp);
 
     int latticeLength() const { return length; }
+    const std::vector<int>& getMapping() const { return log2phys; }
     Cell getLatticePosition(int logQubit) const; // convert 1d -> 2d coordinate
     int getPhysQubitNumber(const Cell& c) const; // convert 2d -> 1d coordinate
     int getArea(const Gate& g) const;
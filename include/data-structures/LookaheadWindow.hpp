@@ -0,0 +1,37 @@
+#ifndef LOOKAHEAD_WINDOW_HPP
+#define LOOKAHEAD_WINDOW_HPP
+
+#include <vector>
+
+#include "Gate.hpp"
+#include "CircuitDAG.hpp"
+
+// CX gates in the DAG layers following the executable layer, used to score SWAPs by their effect
+// on upcoming gates as well as on the current front layer
+// a gate's layer is the number of CX gates on the longest chain of unfinished gates leading up to it,
+// not counting executable ones (ie executable CX gates are in layer 0, which is not part of the window)
+// the layers are only recomputed once the executable layer has changed
+class LookaheadWindow {
+public:
+    // keeps layers 1..depth; layer i is weighted by decay^i
+    LookaheadWindow(int depth, double decay);
+
+    // walk child links from the executable layer, if it changed since the last update
+    // active gates are in flight and count as part of the executable layer
+    void update(const CircuitDAG& circuit);
+
+    int numLayers() const { return layers.size(); }
+    const std::vector<Gate>& getLayer(int i) const { return layers[i]; } // layer i+1
+    double weight(int i) const { return weights[i]; } // weight of layer i+1
+
+private:
+    std::vector<std::vector<Gate>> layers;
+    std::vector<double> weights;
+    std::vector<int> remaining; // scratch: unfinished parents not yet walked, or -1 if not reached
+    std::vector<int> currentLayer, nextLayer; // scratch: gates of the layer being walked and of the next one
+    std::vector<int> touched; // scratch: gates whose entry in 'remaining' must be reset
+    unsigned long version;
+    bool isValid = false;
+};
+
+#endif
@@ -3,12 +3,18 @@
 
 #include "Point.hpp"
 #include <iostream>
+#include <memory_resource>
 
+// elements are surrounded by a one-element border, so the neighbours of any element can be
+// read without bounds checking (the border holds 0 unless set with setBorder())
+// storage order is row-major by default; building with MORTON_LAYOUT stores elements in
+// Z-order (on a padded power-of-two square) so that vertical neighbours stay close in memory
+// elements are allocated from a memory resource (the default resource unless one is given)
 class Matrix {
 public:
-    Matrix(int rows, int cols);
+    Matrix(int rows, int cols, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
     Matrix(int n); // for square matrices
-    Matrix(const Matrix& mat); // copy constructor
+    Matrix(const Matrix& mat, std::pmr::memory_resource* memory = std::pmr::get_default_resource()); // copy constructor
     Matrix(Matrix&& mat); // move constructor
 
     // disable Matrix assignment
@@ -16,25 +22,67 @@ public:
     Matrix& operator=(Matrix&&) = delete;
 
     ~Matrix() {
-        delete[] data;
+        if(data) memory->deallocate(data, size*sizeof(int), alignof(int));
     }
 
     int numRows() const { return rows; }
     int numCols() const { return cols; }
 
+    // flat indices address elements in storage order; points on the border (eg {-1, 0}) are valid
+#ifdef MORTON_LAYOUT
+    int index(const Point& p) const { return dilate(p.x + 1) | (dilate(p.y + 1) << 1); }
+    int neighbour(int idx, int dir) const {
+        unsigned m = idx;
+        switch(dir) {
+            case 0: return (((m & xBits) - 1) & xBits) | (m & yBits);
+            case 1: return (((m & yBits) - 2) & yBits) | (m & xBits);
+            case 2: return (((m | yBits) + 1) & xBits) | (m & yBits);
+            default: return (((m | xBits) + 2) & yBits) | (m & xBits);
+        }
+    }
+#else
+    int index(const Point& p) const { return (p.y + 1)*stride + p.x + 1; }
+    int neighbour(int idx, int dir) const { return idx + deltas[dir]; }
+#endif
+
+    // directions used by neighbour(), in order
+    static constexpr Point directions[4] = {{-1,0}, {0,-1}, {1,0}, {0,1}};
+    static int inverse(int dir) { return dir ^ 2; }
+
     // these access operators do not perform bounds checking
-    int* operator[](int i) { return data + (i*cols); }
-    const int* operator[](int i) const { return data + (i*cols); }
-    int& operator[](const Point& p) { return (*this)[p.y][p.x]; }
-    int operator[](const Point& p) const { return (*this)[p.y][p.x]; }
+    int& at(int idx) { return data[idx]; }
+    int at(int idx) const { return data[idx]; }
+    int& operator[](const Point& p) { return data[index(p)]; }
+    int operator[](const Point& p) const { return data[index(p)]; }
+
+    void setBorder(int value);
 
 private:
+    std::pmr::memory_resource* memory;
     int* data;
     int rows, cols;
+    int size; // number of stored elements (including the border and any padding)
+
+#ifdef MORTON_LAYOUT
+    static constexpr unsigned xBits = 0x55555555;
+    static constexpr unsigned yBits = 0xAAAAAAAA;
+
+    // spreads the low 16 bits of v over the even bits
+    static int dilate(unsigned v) {
+        v = (v | (v << 8)) & 0x00FF00FF;
+        v = (v | (v << 4)) & 0x0F0F0F0F;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    }
+#else
+    int stride; // elements per stored row
+    int deltas[4]; // flat index offsets of the neighbours in each direction
+#endif
 };
 
-void clear(Matrix& mat);
+void clear(Matrix& mat); // zeroes all elements (the border is left as is)
 
 void printMatrix(std::ostream& out, const Matrix& m);
 
-#endif
\ No newline at end of file
+#endif
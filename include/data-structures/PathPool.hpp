@@ -0,0 +1,75 @@
+#ifndef PATH_POOL_HPP
+#define PATH_POOL_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "Point.hpp"
+
+// compact braid path: its first vertex plus a 2-bit step per following vertex
+// (steps index Matrix::directions); the steps are stored in a PathPool
+struct BraidPath {
+    Point start = {0, 0};
+    int length = 0; // number of vertices
+    int offset = -1; // position of the steps in the pool (-1 if nothing is stored)
+
+    int size() const { return length; }
+};
+
+// read-only range over the vertices of a BraidPath; iterating it does not allocate
+// only valid until the next call to PathPool::store()
+class PathView {
+public:
+    class iterator {
+    public:
+        iterator(const unsigned char* steps, int i, int length, const Point& p) :
+            steps(steps), i(i), length(length), p(p) {}
+
+        const Point& operator*() const { return p; }
+        const Point* operator->() const { return &p; }
+        iterator& operator++();
+        bool operator!=(const iterator& other) const { return i != other.i; }
+        bool operator==(const iterator& other) const { return i == other.i; }
+
+    private:
+        const unsigned char* steps;
+        int i, length;
+        Point p;
+    };
+
+    PathView(const unsigned char* steps, const BraidPath& path) : steps(steps), path(path) {}
+
+    iterator begin() const { return iterator(steps, 0, path.length, path.start); }
+    iterator end() const { return iterator(steps, path.length, path.length, path.start); }
+    int size() const { return path.length; }
+
+private:
+    const unsigned char* steps;
+    BraidPath path;
+};
+
+// slab storage for the steps of all braid paths of a run
+// blocks come in power-of-two sizes and released blocks are reused by later paths of the same size class
+class PathPool {
+public:
+    // 'path' must be a chain of adjacent vertices
+    BraidPath store(const std::pmr::vector<Point>& path);
+    void release(BraidPath& path); // return the path's block to the pool (the path becomes empty)
+    void clear(); // release all paths at once
+
+    PathView view(const BraidPath& path) const { return PathView(bytes.data() + (path.offset < 0 ? 0 : path.offset), path); }
+
+    std::size_t peakBytes() const { return peak; } // most bytes ever reserved for steps at once
+
+private:
+    static constexpr int minClass = 3; // smallest block is 8 bytes (32 steps)
+
+    std::vector<unsigned char> bytes;
+    std::vector<std::vector<int>> freeBlocks; // offsets of released blocks, by size class
+    std::size_t peak = 0;
+
+    static int sizeClass(int numSteps);
+};
+
+#endif
@@ -14,4 +14,17 @@ inline Point operator+(const Point& a, const Point& b) {
 // a cell is identified by its top left corner
 using Cell = Point;
 
+// represents an axis-aligned rectangle of lattice vertices (both corners inclusive)
+struct Box {
+    Point lo, hi;
+};
+
+// grow 'b' so that it contains 'p'
+inline void extend(Box& b, const Point& p) {
+    if(p.x < b.lo.x) b.lo.x = p.x;
+    if(p.y < b.lo.y) b.lo.y = p.y;
+    if(p.x > b.hi.x) b.hi.x = p.x;
+    if(p.y > b.hi.y) b.hi.y = p.y;
+}
+
 #endif
\ No newline at end of file
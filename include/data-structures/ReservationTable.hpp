@@ -0,0 +1,26 @@
+#ifndef RESERVATION_TABLE_HPP
+#define RESERVATION_TABLE_HPP
+
+#include "Point.hpp"
+#include "Matrix.hpp"
+#include "PathPool.hpp"
+
+// time-aware counterpart of 'world': stores, for each vertex, the cycle at which its current claim expires
+// a vertex is free at cycle t iff expiry(v) <= t
+// claims may start in the future (reservations), in which case they extend the existing claim
+class ReservationTable {
+public:
+    ReservationTable(int rows, int cols) : expiries(rows, cols) {}
+
+    int numRows() const { return expiries.numRows(); }
+    int numCols() const { return expiries.numCols(); }
+
+    int expiry(const Point& p) const { return expiries[p]; }
+    void claim(const PathView& path, int until); // 'path' is taken until cycle 'until'
+    void reset() { clear(expiries); }
+
+private:
+    Matrix expiries;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef ROUTE_MEMO_HPP
+#define ROUTE_MEMO_HPP
+
+#include <vector>
+
+#include "Point.hpp"
+
+// remembers gates whose braid search failed, along with the region that search explored
+// a failed search stays failed until a vertex inside its region is freed (claims only add obstacles),
+// so such gates are not retried until then
+// freed vertices are tracked at the granularity of square tiles of the lattice
+// failures are kept in a table indexed by gate id (allocated once), so recording one never allocates
+class RouteMemo {
+public:
+    RouteMemo(int rows, int cols, int numGates);
+
+    // record that braiding 'gateId' between 'source' and 'dest' failed after exploring 'region'
+    void recordFailure(int gateId, const Cell& source, const Cell& dest, const Box& region);
+    void forget(int gateId) { failures[gateId].stamp = 0; }
+    bool hasFailed(int gateId) const { return failures[gateId].stamp > clearedAt; }
+
+    // returns false if 'gateId' is known to fail (ie same cells and nothing freed in its region since)
+    bool shouldRetry(int gateId, const Cell& source, const Cell& dest) const;
+
+    void markFreed(const Point& p); // call for every vertex freed in 'world'
+    void markAllFreed() { clearedAt = clock++; } // call when 'world' is cleared
+
+private:
+    struct Failure {
+        Cell source, dest; // gate cells at the time of failure (a remapping invalidates the entry)
+        Box tiles; // tiles covering the explored region
+        unsigned long stamp = 0; // value of 'clock' when the failure was recorded (0 if there is none)
+    };
+
+    static constexpr int tileSize = 8;
+
+    int tileRows, tileCols;
+    std::vector<unsigned long> tileStamps; // value of 'clock' when each tile last had a vertex freed
+    unsigned long clock = 1;
+    unsigned long clearedAt = 0; // failures recorded at or before this stamp are forgotten
+    std::vector<Failure> failures; // by gate id
+};
+
+#endif
@@ -3,8 +3,8 @@
 
 #include <unordered_set>
 
-template<class T>
-inline bool contains(const std::unordered_set<T>& set, const T& item) {
+template<class T, class Hash, class Equal, class Alloc>
+inline bool contains(const std::unordered_set<T, Hash, Equal, Alloc>& set, const T& item) {
     return set.find(item) != set.end();
 }
 
@@ -0,0 +1,8 @@
+#ifndef ALLOC_COUNT_HPP
+#define ALLOC_COUNT_HPP
+
+// number of calls to the global operator new so far
+// only counted when built with COUNT_ALLOCATIONS (which replaces the global operator new); 0 otherwise
+unsigned long numHeapAllocations();
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef ANNEAL_HPP
+#define ANNEAL_HPP
+
+#include "Lattice.hpp"
+#include "partition.hpp"
+
+// settings for annealPlacement()
+struct AnnealOptions {
+    int numChains = 4; // independent annealing chains; the best result is kept
+    int numThreads = 1; // chains run concurrently on up to this many threads; the result does not depend on it
+    int sweeps = 200; // moves per chain, in multiples of the number of coupled qubits
+    int timeLimitMs = 0; // time budget per chain (0 = none); a chain that runs out stops early,
+                         // so the result then depends on machine speed
+    unsigned seed = 1; // chain i draws from a generator seeded with seed + i
+};
+
+// sum over the edges of 'coupling' of edge weight * manhattan distance under grid's mapping
+// 'coupling' must index logical qubits directly (as built by buildWeightedCouplingGraph)
+long long wirelength(const metisGraph& coupling, const Lattice& grid);
+
+// refines grid's mapping by simulated annealing on the wirelength of 'coupling'
+// moves swap a qubit with the qubit (or free cell) near one of its neighbours; the cost change is
+// evaluated from the edges of the two qubits only
+// returns the wirelength of the new mapping (never worse than the original one)
+long long annealPlacement(Lattice& grid, const metisGraph& coupling, const AnnealOptions& options);
+
+#endif
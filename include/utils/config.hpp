@@ -2,16 +2,40 @@
 #define CONFIG_HPP
 
 #include <string>
+#include <vector>
 
 struct Environment {
     std::string fileName;
     int d;
     double timePerCycle;
     bool doInitPlacement;
+    bool doCurvePlacement; // place qubits along a space-filling curve instead of partitioning (for huge circuits)
+    bool doWeightedCoupling; // weight coupling graph edges by interaction count for initial placement
+    double couplingDecay; // relative weight of the last CX gates vs the first ones in the weighted coupling graph
+    bool doAnneal; // refine the initial placement by simulated annealing
+    int annealChains; // number of independent annealing chains (the best one is kept)
+    int annealSweeps; // moves per annealing chain, in multiples of the number of qubits
+    int annealTimeMs; // time budget per annealing chain (0 = none)
+    unsigned annealSeed; // chain i is seeded with annealSeed + i
+    std::string placementCacheDir; // directory of cached initial placements (empty disables the cache)
     bool doSwapOptimizer;
+    bool doSwapOverlap; // schedule SWAP layers alongside in-flight gates instead of draining the lattice
     double swapThreshold; // (scheduled ratio <= threshold) -> trigger placement optimizer
     int maxConsecutiveSWAPLayers; // number of consecutive swap layers allowed
+    int swapWindow; // number of upcoming DAG layers that also score swaps (0 scores the front layer only)
+    double swapDecay; // weight of upcoming layer i is swapDecay^i
+    bool doSlackPriority; // break interference ties by DAG slack before bounding box area
     bool isQFT; // qft circuits need special treatment
+    bool doPathRepair; // repair search state of stalled braids incrementally instead of searching again
+    int repairMemoryMB; // memory budget for search states kept by path repair
+    int windowMargin; // initial margin around a gate's bounding box for windowed A* (0 searches everywhere)
+    int numLandmarks; // number of landmarks used for the ALT heuristic (0 uses manhattan distance only)
+    int landmarkHorizon; // landmark distances stay valid for this many cycles after they are computed
+    int lookahead; // how many cycles ahead stalled braids may be reserved (0 disables reservations)
+    int numThreads; // worker threads for parallel phases (1 runs everything on the main thread)
+    std::vector<int> sweepDistances; // critpath: distances to tabulate the critical path for (empty = only -d)
+    int slackBuckets; // critpath: number of buckets in the per-gate slack histogram (0 disables it)
+    bool doCrossCheck; // critpath: also simulate the circuit event by event and compare the results
 };
 
 Environment parse(int argc, char* argv[]);
@@ -0,0 +1,22 @@
+#ifndef CRITPATH_HPP
+#define CRITPATH_HPP
+
+#include <vector>
+#include "CircuitDAG.hpp"
+#include "config.hpp"
+
+// length in cycles of the critical path of 'circuit' when every gate takes getCost() cycles and
+// gates start as soon as their parents are done (ie with unlimited braiding resources)
+// longest-path dynamic program over the DAG in topological order, O(gates)
+long long criticalPath(const CircuitDAG& circuit, const Environment& env);
+
+// critical path for each of the given surface code distances, in a single traversal of the circuit
+// (every gate cost is affine in d, so all distances are carried along at once; O(gates * distances))
+std::vector<long long> criticalPathSweep(const CircuitDAG& circuit, const Environment& env, const std::vector<int>& distances);
+
+// same result as criticalPath(), by simulating the execution with a queue of completion events
+// (O(gates log gates); kept to cross-check criticalPath())
+// resolves every gate of 'circuit' and resets it afterwards
+long long criticalPathEventDriven(CircuitDAG& circuit, const Environment& env);
+
+#endif
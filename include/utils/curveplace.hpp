@@ -0,0 +1,24 @@
+#ifndef CURVE_PLACE_HPP
+#define CURVE_PLACE_HPP
+
+#include <vector>
+#include "Point.hpp"
+#include "Lattice.hpp"
+#include "partition.hpp"
+
+// linear arrangement of the vertices of a (weighted) coupling graph, so that strongly coupled vertices
+// end up close together: a breadth-first search from a pseudo-peripheral vertex of each component,
+// visiting heavier edges first (like reverse Cuthill-McKee, but weight-aware)
+// components are listed one after another; isolated vertices come last
+// returns vertex indices of 'g' (not ids)
+std::vector<int> bfsOrder(const metisGraph& g);
+
+// every cell of a length x length lattice, in the order of a Hilbert curve
+// for lengths that are not powers of two, the curve of the next power of two is clipped to the lattice
+std::vector<Cell> hilbertCurve(int length);
+
+// initial placement in O(m log m): orders the qubits with bfsOrder() and spreads that order
+// evenly along a Hilbert curve over the lattice
+std::vector<int> curvePlacement(const metisGraph& coupling, const Lattice& grid);
+
+#endif
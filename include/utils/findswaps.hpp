@@ -1,17 +1,55 @@
 #ifndef FIND_SWAPS_HPP
 #define FIND_SWAPS_HPP
 
+#include <memory_resource>
 #include <vector>
 #include <stack>
+#include <unordered_set>
 #include "Matrix.hpp"
+#include "CycleArena.hpp"
 #include "Gate.hpp"
 #include "Lattice.hpp"
+#include "LookaheadWindow.hpp"
+
+// a SWAP gate scheduled by findSwaps() and the braid it claimed
+struct SwapBraid {
+    Gate swap;
+    std::pmr::vector<Point> path;
+};
+
+// optional settings for findSwaps()
+struct SwapOptions {
+    // candidate swaps are scored on up to this many threads; the result does not depend on it
+    int numThreads = 1;
+
+    // if non-null, swaps are also scored by the weighted interference within its (up to date) layers
+    const LookaheadWindow* window = nullptr;
+
+    // if non-null, these logical qubits are never swapped (eg b/c they are used by in-flight gates)
+    const std::pmr::unordered_set<int>* excludedQubits = nullptr;
+
+    // if non-null, receives each scheduled swap along with its braid
+    std::pmr::vector<SwapBraid>* braids = nullptr;
+
+    // braids and the state kept for the whole call (eg the claimed lattice) are allocated from 'memory';
+    // the state of each search on the calling thread is allocated from 'scratch' (reset after every search)
+    // if non-null (other threads use arenas of their own)
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource();
+    CycleArena* scratch = nullptr;
+};
 
 // returns the number of SWAP gates scheduled
 // takes grid by reference and alters its logical->physical qubit mapping
-// frontLayer should only consist of CX gates/two-qubit gates
+// frontLayer should only consist of CX gates/two-qubit gates; their ids are overwritten with their index
+// braids of the scheduled swaps avoid every vertex taken in 'world'
 // int& res is assigned the number of vertices used by scheduled swaps (for resource utilization)
 // TODO: make a better interface for this?
-int findSwaps(std::vector<Gate> frontLayer, Lattice& grid, const Matrix& world, int& res);
+int findSwaps(
+    std::vector<Gate>& frontLayer,
+    Lattice& grid,
+    const Matrix& world,
+    int& res,
+    const SwapOptions& options = SwapOptions()
+);
 
-#endif
\ No newline at end of file
+#endif
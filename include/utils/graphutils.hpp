@@ -10,9 +10,50 @@
 // splits vertices into components, sorted by size (small -> large)
 // vertices within paths are listed in order from one end to the other
 // vertices within cycles are listed in order along said cycle (w/ arbitrary starting vertex)
-std::vector<std::vector<int>> getComponentsInOrder(const Graph& g);
+// the components (and any scratch space) are allocated from 'memory'
+std::pmr::vector<std::pmr::vector<int>> getComponentsInOrder(
+    const Graph& g,
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+);
 
-Graph buildInterferenceGraph(const std::vector<Gate>& gates, const Lattice& grid);
+// lets gate containers hold either gates or pointers to gates
+inline const Gate& deref(const Gate& g) { return g; }
+inline const Gate& deref(const Gate* g) { return *g; }
+
+// one vertex per gate, joined when the gates' bounding boxes overlap; allocated from 'memory'
+// 'gates' may be any vector of Gate or const Gate* (whatever its allocator)
+template<class Gates>
+Graph buildInterferenceGraph(
+    const Gates& gates,
+    const Lattice& grid,
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+) {
+    Graph interference (memory);
+    for(int i = 0; i < gates.size(); ++i) {
+        const Gate& g1 = deref(gates[i]);
+        interference.addVertex(g1.id);
+        for(int j = 0; j < i; ++j) {
+            const Gate& g2 = deref(gates[j]);
+            if(grid.checkOverlap(g1, g2)) interference.addEdge(g1.id, g2.id);
+        }
+    }
+    return interference;
+}
+
+// change in buildInterferenceGraph(gates, grid).numEdges() if logical qubits q1 and q2 swapped places
+// only gates acting on q1 or q2 are re-checked; grid is not modified (safe to call concurrently)
+int interferenceDelta(const std::vector<Gate>& gates, const Lattice& grid, int q1, int q2);
+
+// brings 'interference' (built from 'gates') up to date after q1 and q2 swapped places in grid's mapping
+// only edges of gates acting on q1 or q2 are re-checked; scratch space is allocated from 'memory'
+void updateInterferenceGraph(
+    Graph& interference,
+    const std::vector<Gate>& gates,
+    const Lattice& grid,
+    int q1,
+    int q2,
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+);
 
 // returns max degree vertex satisfying a filter, or -1 if there is none
 // both tiebreaker and filter should take Graph::Vertex instances as arguments
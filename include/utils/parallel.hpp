@@ -0,0 +1,82 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// calls f(i) for every i in [0, n) using up to 'numThreads' threads (the calling thread included)
+// iterations are handed out one at a time, so f must be safe to call concurrently for different i
+// with numThreads <= 1 this is a plain loop and no threads are started
+template<class F>
+void parallelFor(int n, int numThreads, F f) {
+    numThreads = std::min(numThreads, n);
+    if(numThreads <= 1) {
+        for(int i = 0; i < n; ++i) f(i);
+        return;
+    }
+
+    std::atomic<int> next (0);
+    auto work = [&]() {
+        for(int i = next++; i < n; i = next++) f(i);
+    };
+    std::vector<std::thread> workers;
+    for(int t = 1; t < numThreads; ++t) workers.emplace_back(work);
+    work();
+    for(std::thread& t : workers) t.join();
+}
+
+// work-stealing pool for recursive (fork-only) task parallelism
+// every worker owns a deque: it pushes and pops its own tasks at the back, while idle workers
+// steal the oldest tasks (usually the largest subproblems) from the front of the others
+// tasks may spawn further tasks; wait() returns once every spawned task has finished
+// idle workers sleep until a task is spawned, so a pool may be kept alive between bursts of work
+class TaskPool {
+public:
+    using Task = std::function<void(int)>; // receives the index of the worker running it
+
+    // 'numThreads' includes the thread calling wait(), which acts as worker 0
+    explicit TaskPool(int numThreads);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    int numWorkers() const { return queues.size(); }
+
+    void spawn(Task task); // queue a task on the calling worker (or on worker 0 from outside the pool)
+    void wait(); // run tasks until none are left
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<int> numPending; // tasks spawned but not yet finished
+    std::atomic<int> numQueued; // tasks spawned but not yet started
+    std::atomic<bool> isStopping;
+
+    // idle workers (and wait()) sleep on 'idle'; wakers only take the lock if someone is asleep
+    std::mutex idleLock;
+    std::condition_variable idle;
+    std::atomic<int> numSleeping;
+
+    void sleepUntil(bool (TaskPool::*isReady)() const);
+    void wakeAll();
+    bool hasQueuedTasks() const { return numQueued > 0 || isStopping; }
+    bool isDoneOrQueued() const { return numPending == 0 || numQueued > 0; }
+
+    bool runOne(int self); // run one task (own or stolen); returns false if none was found
+    void workerLoop(int self);
+};
+
+#endif
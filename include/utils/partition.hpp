@@ -3,6 +3,7 @@
 
 #include "metis.h"
 #include "Graph.hpp"
+#include "CircuitDAG.hpp"
 #include "Lattice.hpp"
 
 #include <vector>
@@ -12,15 +13,30 @@ struct metisGraph {
     std::vector<idx_t> xadj; // length of each adjacency list
     std::vector<idx_t> adjncy; // combined adjacency lists for each vertice
     std::vector<int> id_map; // conversion from index to actual Graph::Vertex id
+    std::vector<idx_t> adjwgt; // edge weights, parallel to adjncy (empty if unweighted)
 };
 
 // convert graph to metis representation
 metisGraph convert2metisGraph(const Graph& g);
 
+// logical qubit coupling graph of a circuit (unweighted), built from its gate list in one pass
+Graph buildCouplingGraph(const CircuitDAG& circuit);
+
+// weighted coupling graph in metis representation, built from the circuit's gate list in one pass
+// each CX gate adds to the weight of the edge between its qubits; the i-th of n gates adds
+// decay^(i/n), so the last gates count 'decay' times as much as the first ones (1 = plain counts)
+metisGraph buildWeightedCouplingGraph(const CircuitDAG& circuit, double decay);
+
+// total manhattan distance between the qubits of every CX gate in the circuit under grid's mapping
+long long couplingCost(const CircuitDAG& circuit, const Lattice& grid);
+
 // initialize metis options (call before initialPlacement)
 void initMetisOptions();
 
 // perform recursive partition to get initial placement
-std::vector<int> initialPlacement(const Graph& coupling, const Lattice& grid);
+// with numThreads > 1 the sub-bisections run as tasks on a work-stealing pool; the placement
+// is the same for any number of threads
+std::vector<int> initialPlacement(const Graph& coupling, const Lattice& grid, int numThreads = 1);
+std::vector<int> initialPlacement(const metisGraph& coupling, const Lattice& grid, int numThreads = 1); // uses edge weights
 
 #endif
\ No newline at end of file
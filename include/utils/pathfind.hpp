@@ -1,19 +1,66 @@
 #ifndef PATHFIND_HPP
 #define PATHFIND_HPP
 
+#include <memory_resource>
 #include <vector>
 
 #include "Lattice.hpp"
 #include "Matrix.hpp"
+#include "Landmarks.hpp"
+
+// optional settings for braid() and pathfind()
+struct SearchOptions {
+    // if non-null, covers every vertex looked at (including obstacles) once the search is done
+    // (braid() resets it, pathfind() extends it)
+    Box* explored = nullptr;
+
+    // if non-null, vertices outside of it are treated as obstacles (the start must lie inside it)
+    const Box* window = nullptr;
+
+    // if non-null, the ALT heuristic is combined with the manhattan distance
+    // and vertices that provably cannot reach the destination are pruned
+    // must be valid for the current cycle
+    const Landmarks* landmarks = nullptr;
+
+    // returned paths are allocated from 'memory', and the search state (eg copies of the lattice) from 'scratch'
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource();
+    std::pmr::memory_resource* scratch = std::pmr::get_default_resource();
+};
 
 // pathfinds for Cell -> Cell
 // returns the path found, or an empty vector if no path is found
-std::vector<Point> braid(const Gate& g, const Lattice& grid, const Matrix& world);
+std::pmr::vector<Point> braid(
+    const Gate& g,
+    const Lattice& grid,
+    const Matrix& world,
+    const SearchOptions& options = SearchOptions()
+);
+
+// braid() restricted to the bounding box of the gate's cells plus 'margin' vertices on each side
+// if no path is found, the margin is doubled until the window covers the whole lattice
+// (or until a failed search did not reach the window's edge, which means there is no path at all)
+// any window in 'options' is ignored
+std::pmr::vector<Point> braidWindowed(
+    const Gate& g,
+    const Lattice& grid,
+    const Matrix& world,
+    int margin,
+    const SearchOptions& options = SearchOptions()
+);
 
 // performs A* search for Point -> Cell
 // returns the path found, or an empty vector if no path is found
 // world[i][j] == 0 indicates that that vertex is free; otherwise it is taken (ie is an obstacle).
-std::vector<Point> pathfind(const Point& start, const Cell& dest, Matrix world);
+std::pmr::vector<Point> pathfind(
+    const Point& start,
+    const Cell& dest,
+    const Matrix& world,
+    const SearchOptions& options = SearchOptions()
+);
+
+// search statistics accumulated over all calls (safe to update from several threads)
+unsigned long numSearches(); // calls to pathfind()
+unsigned long numExpansions(); // nodes expanded by pathfind()
 
 // manhattan/L1 distance: used as heuristic cost for A* search
 // equals 0 iff 'vertex' is a corner of 'dest'
@@ -0,0 +1,90 @@
+#ifndef PATH_REPAIR_HPP
+#define PATH_REPAIR_HPP
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <memory_resource>
+#include <vector>
+
+#include "Gate.hpp"
+#include "Lattice.hpp"
+#include "Matrix.hpp"
+
+// incremental Cell -> Cell braiding for gates that stay stalled over many cycles (LPA*)
+// search state is kept per gate and repaired using the vertices claimed/freed since its last search,
+// instead of running pathfind() from scratch every time the gate is retried
+// the total memory used by kept states (including their heaps) is bounded; least recently used states are dropped
+// and the gate falls back to a fresh search the next time it is routed
+// the buffers of dropped states are reused by new ones while within the budget, so a steady stream of
+// stalled gates does not touch the global heap
+class PathRepairer {
+public:
+    // 'memoryBudget' is the maximum number of bytes used by kept search states
+    PathRepairer(int rows, int cols, std::size_t memoryBudget);
+
+    // same contract as braid() in pathfind.hpp (although ties between shortest paths may break differently)
+    // the path is allocated from 'memory'
+    std::pmr::vector<Point> braid(
+        const Gate& g,
+        const Lattice& grid,
+        const Matrix& world,
+        Box* explored = nullptr,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+    );
+    void forget(int gateId); // drop search state (eg once the gate has been scheduled)
+
+    void notifyChanged(const Point& p); // call for every vertex claimed or freed in 'world'
+    void notifyCleared(); // call when 'world' is cleared; drops all search states
+
+    unsigned long numRepairs() const { return repairs; }
+    unsigned long numFreshSearches() const { return freshSearches; }
+    unsigned long numExpansions() const { return expansions; } // vertices expanded by LPA* (not counted by pathfind())
+
+private:
+    struct QueueEntry {
+        int k1, k2; // LPA* priority key [min(g,rhs) + h; min(g,rhs)]
+        int v;
+    };
+
+    struct SearchState {
+        Cell source, dest;
+        std::vector<int> g, rhs; // indexed by vertex number; the last entry is a virtual goal vertex
+        std::vector<QueueEntry> queue; // binary heap w/ lazy deletion (compacted once mostly stale)
+        Box touched; // vertices expanded so far (plus a 1-vertex margin)
+        std::size_t logPos; // position in 'changeLog' up to which changes have been applied
+        std::pmr::list<int>::iterator lruPos;
+        std::size_t bytes = 0; // memory counted against the budget for this state
+    };
+
+    int rows, cols;
+    int goal; // index of the virtual goal vertex (connected to each corner of the destination cell)
+    std::size_t memoryBudget;
+    std::size_t usedBytes = 0; // sum of the 'bytes' of the states and of the spares
+
+    std::pmr::unsynchronized_pool_resource nodes; // recycles the nodes of 'states' and 'lru' (must outlive them)
+    std::pmr::unordered_map<int, SearchState> states {&nodes};
+    std::pmr::list<int> lru {&nodes}; // gate ids, most recently used first
+    std::vector<SearchState> spares; // dropped states whose buffers are kept for new states
+
+    std::vector<Point> changeLog; // vertices changed in 'world' since the oldest state's last search
+    std::size_t logBase = 0; // absolute position of changeLog[0]
+
+    unsigned long repairs = 0;
+    unsigned long freshSearches = 0;
+    unsigned long expansions = 0;
+
+    void reset(SearchState& s, const Cell& source, const Cell& dest, const Matrix& world);
+    void updateVertex(SearchState& s, int v, const Matrix& world);
+    void computeShortestPath(SearchState& s, const Matrix& world);
+    void trimLog();
+    void compactQueue(SearchState& s);
+    void updateUsage(SearchState& s); // recount the state's memory, then evict other states until within budget
+    std::pmr::unordered_map<int, SearchState>::iterator dropState(std::pmr::unordered_map<int, SearchState>::iterator iter);
+
+    int heuristic(const SearchState& s, int v) const;
+    bool isSource(const SearchState& s, int v) const;
+    QueueEntry calcKey(const SearchState& s, int v) const;
+};
+
+#endif
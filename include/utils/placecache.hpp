@@ -0,0 +1,57 @@
+#ifndef PLACE_CACHE_HPP
+#define PLACE_CACHE_HPP
+
+#include <string>
+#include <vector>
+#include "config.hpp"
+#include "partition.hpp"
+
+// version of the placement algorithms (partition.cpp, curveplace.cpp, anneal.cpp);
+// bump it whenever they compute different placements for the same input, so older entries are not reused
+// (independent of the version of the entry file format)
+constexpr int placementAlgorithmVersion = 1;
+
+// identifies a cached placement: the coupling graph it was computed for, the lattice size,
+// the placement options that influence the result and the algorithm version that computed it
+struct PlacementKey {
+    int algorithm = placementAlgorithmVersion;
+    unsigned long long graphHash = 0;
+    int numQubits = 0;
+    int latticeLength = 0;
+    std::string options;
+
+    std::string name() const; // name of the cache entry (hex hash of all fields)
+    bool operator==(const PlacementKey& other) const;
+};
+
+// a placement stored in the cache
+struct PlacementEntry {
+    PlacementKey key;
+    std::vector<int> mapping; // logical -> physical qubit
+};
+
+// hash of the vertices, edges and edge weights of a coupling graph
+// (independent of hash-table iteration order; the graph's vertex indices must be logical qubits)
+unsigned long long hashCouplingGraph(const metisGraph& coupling);
+
+// key for the placement that the given options would compute for 'coupling' on a lattice of the given length
+PlacementKey makePlacementKey(const metisGraph& coupling, int latticeLength, const Environment& env);
+
+// look up a placement in cache directory 'dir'; returns false on a miss (or an unreadable entry)
+bool loadPlacement(const std::string& dir, const PlacementKey& key, std::vector<int>& mapping);
+
+// store a placement in cache directory 'dir' (created if needed), replacing any entry with the same key
+// returns false if the entry could not be written
+bool storePlacement(const std::string& dir, const PlacementKey& key, const std::vector<int>& mapping);
+
+// read a single cache entry file; returns false if it is not a valid entry
+bool readPlacementEntry(const std::string& path, PlacementEntry& entry);
+
+// paths of all cache entry files in 'dir', sorted by name
+std::vector<std::string> listPlacementEntries(const std::string& dir);
+
+// paths of the temporary files in 'dir' that stores write before renaming them into place, sorted by name
+// (left behind by runs that were interrupted while storing, or in use by a store that is still running)
+std::vector<std::string> listTemporaryFiles(const std::string& dir);
+
+#endif
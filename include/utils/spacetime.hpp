@@ -0,0 +1,29 @@
+#ifndef SPACE_TIME_HPP
+#define SPACE_TIME_HPP
+
+#include <memory_resource>
+#include <vector>
+
+#include "Gate.hpp"
+#include "Lattice.hpp"
+#include "ReservationTable.hpp"
+
+// space-time pathfinding for Cell -> Cell
+// a braid holds its whole path for its whole duration, so waiting in place never helps:
+// the earliest start time of a path is the latest expiry among its vertices.
+// finds the path with the earliest start time and, among those, the shortest one, considering only
+// vertices that expire at or before 'now' + 'horizon'
+// returns the path found, or an empty vector if no path is found; 'start' is set to its start time
+// the path is allocated from 'memory', and the search state from 'scratch'
+std::pmr::vector<Point> braidSpaceTime(
+    const Gate& g,
+    const Lattice& grid,
+    const ReservationTable& table,
+    int now,
+    int horizon,
+    int& start,
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+    std::pmr::memory_resource* scratch = std::pmr::get_default_resource()
+);
+
+#endif
@@ -2,16 +2,34 @@
 
 #include <cassert>
 
-ActiveGate activateGate(const Gate& g, std::vector<Point> resources, Matrix& world, const Environment& env) {
+ActiveGate activateGate(
+    const Gate& g,
+    const std::pmr::vector<Point>& resources,
+    Matrix& world,
+    PathPool& paths,
+    const Environment& env
+) {
     for(const Point& p : resources) {
         assert(world[p] == 0); // make sure resource is not already taken
         world[p] = 1;
     }
-    return {g, std::move(resources), getCost(g.name, env)};
+    return {g.id, g.control, g.target, paths.store(resources), getCost(g.name, env)};
 }
 
-void deactivateGate(const ActiveGate& g, Matrix& world) {
-    for(const Point& p : g.braidPath) world[p] = 0;
+ActiveGate reserveGate(
+    const Gate& g,
+    const std::pmr::vector<Point>& resources,
+    int delay,
+    Matrix& world,
+    PathPool& paths,
+    const Environment& env
+) {
+    for(const Point& p : resources) ++world[p]; // world counts the claims on each vertex
+    return {g.id, g.control, g.target, paths.store(resources), getCost(g.name, env), -delay};
+}
+
+void deactivateGate(const ActiveGate& g, Matrix& world, const PathPool& paths) {
+    for(const Point& p : paths.view(g.braidPath)) --world[p];
 }
 
 int getCost(const std::string& name, const Environment& env) {
@@ -0,0 +1,24 @@
+#include "ActiveGateQueue.hpp"
+
+#include <cassert>
+
+void ActiveGateQueue::push(ActiveGate g, int now) {
+    g.finishCycle = now + g.cycleCost - g.lifetime;
+    gates.push_front(std::move(g));
+    heap.push({gates.front().finishCycle, numPushed++, gates.begin()});
+}
+
+ActiveGate ActiveGateQueue::popCompleted() {
+    assert(!heap.empty());
+    auto it = heap.top().gate;
+    heap.pop();
+    ActiveGate g = std::move(*it);
+    gates.erase(it);
+    g.lifetime = g.cycleCost; // for isDone()
+    return g;
+}
+
+void ActiveGateQueue::clear() {
+    gates.clear();
+    while(!heap.empty()) heap.pop(); // keeps the heap's storage
+}
@@ -1,5 +1,6 @@
 #include "CircuitDAG.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include "QASMparser.h"
 
@@ -49,29 +50,79 @@ void CircuitDAG::build() {
 
             targetDepId = parseDependency(gate.target, false);
 
-            // check if gate has no dependencies
-            if(controlDepId == -1 && targetDepId == -1)
-                canExecute.insert(node.g.id);
-            
             gateList.push_back(std::move(node));
         }
     }
 
     assert(numQubits <= parser.getNqubits());
+    reset(); // gates without dependencies are executable
+}
+
+void CircuitDAG::computeTiming(const std::function<int(const Gate&)>& cost) {
+    int n = gateList.size();
+    std::vector<int> duration (n);
+    for(int id = 0; id < n; ++id) duration[id] = cost(gateList[id].g);
+
+    // gate ids follow the circuit file, so parents always have smaller ids than their children
+    asap.assign(n, 0);
+    criticalPathLength = 0;
+    for(int id = 0; id < n; ++id) {
+        const GateNode& node = gateList[id];
+        int finish = asap[id] + duration[id];
+        criticalPathLength = std::max(criticalPathLength, finish);
+        int childIdList[2] = { node.controlChildId, node.targetChildId };
+        for(int childId : childIdList) {
+            if(childId != -1) asap[childId] = std::max(asap[childId], finish);
+        }
+    }
+
+    // a gate must start early enough for each child to start by its own latest start
+    alap.assign(n, 0);
+    for(int id = n - 1; id >= 0; --id) {
+        const GateNode& node = gateList[id];
+        int latestFinish = criticalPathLength;
+        int childIdList[2] = { node.controlChildId, node.targetChildId };
+        for(int childId : childIdList) {
+            if(childId != -1) latestFinish = std::min(latestFinish, alap[childId]);
+        }
+        alap[id] = latestFinish - duration[id];
+        assert(alap[id] >= asap[id]);
+    }
+}
+
+void CircuitDAG::setState(int id, GateState state) {
+    // the executable layer stays sorted by gate id, so the order in which it is walked depends only on
+    // the circuit and not on the history of activations; the active list is unordered (swap-with-last)
+    if(states[id] == GateState::executable) {
+        executable.erase(std::lower_bound(executable.begin(), executable.end(), id));
+    } else if(states[id] == GateState::active) { // move the last gate into the vacated slot
+        int last = active.back();
+        active[listPos[id]] = last;
+        listPos[last] = listPos[id];
+        active.pop_back();
+    }
+    if(state == GateState::executable) {
+        executable.insert(std::lower_bound(executable.begin(), executable.end(), id), id);
+    } else if(state == GateState::active) {
+        listPos[id] = active.size();
+        active.push_back(id);
+    }
+    states[id] = state;
 }
 
 void CircuitDAG::activateGate(int id) {
-    int removed = canExecute.erase(id);
-    assert(removed == 1); // make sure gate was actually executable
+    assert(isExecutable(id)); // make sure gate was actually executable
+    setState(id, GateState::active);
+    ++version;
 }
 
 void CircuitDAG::resolveGate(int id) {
     GateNode& node = gateList[id];
     
     // a gate should not be resolved twice in a working algorithm
-    assert(!node.finished);
-    node.finished = true;
-    canExecute.erase(id);
+    assert(!isFinished(id));
+    setState(id, GateState::finished);
+    ++version;
 
     int childIdList[2] = { node.controlChildId, node.targetChildId };
     for(int childId : childIdList) {
@@ -79,7 +130,7 @@ void CircuitDAG::resolveGate(int id) {
         GateNode& child = gateList[childId];
         child.numParentsFinished++;
         if(child.numParentsFinished == child.numDependencies)
-            canExecute.insert(child.g.id);
+            setState(childId, GateState::executable);
         }
     }
 }
@@ -89,10 +140,13 @@ const Gate& CircuitDAG::get(int id) const {
 }
 
 void CircuitDAG::reset() {
-    canExecute.clear();
+    states.assign(gateList.size(), GateState::waiting);
+    listPos.assign(gateList.size(), -1);
+    executable.clear();
+    active.clear();
+    ++version;
     for(GateNode& node : gateList) {
         node.numParentsFinished = 0;
-        node.finished = false;
-        if(node.numDependencies == 0) canExecute.insert(node.g.id);
+        if(node.numDependencies == 0) setState(node.g.id, GateState::executable);
     }
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "CycleArena.hpp"
+
+#include <algorithm>
+
+CycleArena::CycleArena(std::size_t initialBytes) {
+    addChunk(std::max<std::size_t>(initialBytes, 64));
+}
+
+std::size_t CycleArena::capacity() const {
+    std::size_t total = 0;
+    for(const Chunk& c : chunks) total += c.size;
+    return total;
+}
+
+void CycleArena::reset() {
+    if(chunks.size() > 1) { // grew during the last cycle: keep one chunk large enough for all of it
+        std::size_t total = capacity();
+        chunks.clear();
+        addChunk(total);
+    }
+    offset = 0;
+    used = 0;
+}
+
+void CycleArena::addChunk(std::size_t size) {
+    chunks.push_back({ std::unique_ptr<std::byte[]>(new std::byte[size]), size });
+}
+
+void* CycleArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    Chunk* c = &chunks.back();
+    void* p = c->bytes.get() + offset;
+    std::size_t space = c->size - offset;
+    if(!std::align(alignment, bytes, p, space)) { // start a new chunk, at least double the size of the last one
+        used += offset;
+        addChunk(std::max(2*c->size, bytes + alignment));
+        c = &chunks.back();
+        p = c->bytes.get();
+        space = c->size;
+        std::align(alignment, bytes, p, space);
+    }
+    offset = static_cast<std::byte*>(p) - c->bytes.get() + bytes;
+    return p;
+}
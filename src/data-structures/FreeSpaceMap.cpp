@@ -0,0 +1,49 @@
+#include "FreeSpaceMap.hpp"
+
+FreeSpaceMap::FreeSpaceMap(int rows, int cols) : labels(rows, cols) {}
+
+void FreeSpaceMap::update(const Matrix& world) {
+    if(!dirty) return;
+    dirty = false;
+    clear(labels);
+
+    static const Point directions[4] = {{-1,0}, {0,-1}, {1,0}, {0,1}};
+
+    // flood fill each unlabelled free vertex
+    int numComponents = 0;
+    for(int i = 0; i < world.numRows(); ++i) {
+        for(int j = 0; j < world.numCols(); ++j) {
+            Point p = {j, i};
+            if(world[p] != 0 || labels[p] != 0) continue;
+
+            labels[p] = ++numComponents;
+            stk.push_back(p);
+            while(!stk.empty()) {
+                Point current = stk.back();
+                stk.pop_back();
+                for(const Point& dir : directions) {
+                    Point next = current + dir;
+                    if(next.x < 0 || next.x >= world.numCols() || next.y < 0 || next.y >= world.numRows()) {
+                        continue;
+                    }
+                    if(world[next] != 0 || labels[next] != 0) continue;
+                    labels[next] = numComponents;
+                    stk.push_back(next);
+                }
+            }
+        }
+    }
+}
+
+bool FreeSpaceMap::mayConnect(const Cell& source, const Cell& dest) const {
+    static const Point corners[4] = {{0,0}, {0,1}, {1,0}, {1,1}};
+
+    for(const Point& p : corners) {
+        int label = labels[source + p];
+        if(label == 0) continue; // braid() cannot start from an occupied corner
+        for(const Point& q : corners) {
+            if(labels[dest + q] == label) return true;
+        }
+    }
+    return false;
+}
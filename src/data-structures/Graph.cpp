@@ -1,7 +1,7 @@
 #include "Graph.hpp"
 
 void Graph::addVertex(int id) {
-    graph.insert({id, Vertex(id)});
+    graph.try_emplace(id, id);
 }
 
 void Graph::addEdge(int id1, int id2) {
@@ -12,6 +12,12 @@ void Graph::addEdge(int id1, int id2) {
         ++size; // increment if edge was not already present
 }
 
+void Graph::deleteEdge(int id1, int id2) {
+    graph.at(id2).neighbours.erase(id1);
+    if(graph.at(id1).neighbours.erase(id2) != 0)
+        --size; // decrement if edge was present
+}
+
 void Graph::deleteVertex(int id) {
     for(int neighbour : graph.at(id).neighbours) {
         graph.at(neighbour).neighbours.erase(id);
@@ -0,0 +1,71 @@
+#include "Landmarks.hpp"
+
+#include <algorithm>
+#include <limits>
+
+Landmarks::Landmarks(int rows, int cols, int count) :
+    rows(rows), cols(cols), count(count), dist(count*rows*cols)
+{}
+
+void Landmarks::compute(const ReservationTable& table, int until) {
+    static const Point directions[4] = {{-1,0}, {0,-1}, {1,0}, {0,1}};
+
+    int n = rows*cols;
+    auto isFree = [&](int v) -> bool { return table.expiry({v%cols, v/cols}) <= until; };
+
+    // choose landmarks farthest-first: each landmark maximizes its distance to the previous ones
+    // (vertices not reached by any previous landmark come first, so every component gets one)
+    nearest.assign(n, std::numeric_limits<int>::max());
+    queue.resize(n);
+    std::fill(dist.begin(), dist.end(), -1);
+    for(int l = 0; l < count; ++l) {
+        int landmark = -1;
+        for(int v = 0; v < n; ++v) {
+            if(isFree(v) && (landmark == -1 || nearest[v] > nearest[landmark])) landmark = v;
+        }
+        if(landmark == -1 || nearest[landmark] == 0) break; // no free vertices left to choose from
+
+        // BFS from the landmark
+        int* d = dist.data() + l*n;
+        int head = 0, tail = 0;
+        d[landmark] = 0;
+        queue[tail++] = landmark;
+        while(head < tail) {
+            int v = queue[head++];
+            nearest[v] = std::min(nearest[v], d[v]);
+            Point p = { v%cols, v/cols };
+            for(const Point& dir : directions) {
+                Point next = p + dir;
+                if(next.x < 0 || next.x >= cols || next.y < 0 || next.y >= rows) continue;
+                int u = next.y*cols + next.x;
+                if(d[u] != -1 || !isFree(u)) continue;
+                d[u] = d[v] + 1;
+                queue[tail++] = u;
+            }
+        }
+    }
+    validUntil = until;
+}
+
+int Landmarks::estimate(const Point& v, const Cell& dest) const {
+    static const Point corners[4] = {{0,0}, {0,1}, {1,0}, {1,1}};
+
+    int n = rows*cols;
+    int vi = v.y*cols + v.x;
+    int best = unreachable;
+    for(const Point& p : corners) {
+        Point c = dest + p;
+        int ci = c.y*cols + c.x;
+
+        // triangle inequality: |d(l,c) - d(l,v)| <= d(v,c) for every landmark l
+        int bound = 0;
+        for(int l = 0; l < count && bound != unreachable; ++l) {
+            int dv = dist[l*n + vi];
+            int dc = dist[l*n + ci];
+            if((dv == -1) != (dc == -1)) bound = unreachable; // v and c lie in different components
+            else if(dv != -1) bound = std::max(bound, std::abs(dc - dv));
+        }
+        if(bound != unreachable && (best == unreachable || bound < best)) best = bound;
+    }
+    return best;
+}
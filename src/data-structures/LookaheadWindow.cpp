@@ -0,0 +1,55 @@
+#include "LookaheadWindow.hpp"
+
+#include <algorithm>
+
+LookaheadWindow::LookaheadWindow(int depth, double decay) : layers(depth), weights(depth) {
+    double w = 1;
+    for(int i = 0; i < depth; ++i) {
+        w *= decay;
+        weights[i] = w;
+    }
+}
+
+void LookaheadWindow::update(const CircuitDAG& circuit) {
+    if(isValid && version == circuit.getVersion()) return;
+    isValid = true;
+    version = circuit.getVersion();
+    for(auto& layer : layers) layer.clear();
+    remaining.resize(circuit.numGates(), -1);
+
+    // walk the DAG one layer at a time; a gate is reached once all of its unfinished parents were walked,
+    // so it belongs to the layer of its last parent (plus one for CX gates)
+    const std::vector<int>& executable = circuit.getExecutableGates();
+    const std::vector<int>& active = circuit.getActiveGates();
+    currentLayer.assign(executable.begin(), executable.end());
+    currentLayer.insert(currentLayer.end(), active.begin(), active.end());
+    std::sort(currentLayer.begin(), currentLayer.end()); // keep the window independent of list order
+    nextLayer.clear();
+    for(int layer = 0; layer < numLayers() && !currentLayer.empty(); ++layer) {
+        for(std::size_t i = 0; i < currentLayer.size(); ++i) { // single-qubit gates extend the current layer
+            const CircuitDAG::GateNode& node = circuit.getNode(currentLayer[i]);
+            int childIdList[2] = { node.controlChildId, node.targetChildId };
+            for(int childId : childIdList) {
+                if(childId == -1) continue;
+                const CircuitDAG::GateNode& child = circuit.getNode(childId);
+                if(remaining[childId] == -1) {
+                    remaining[childId] = child.numDependencies - child.numParentsFinished;
+                    touched.push_back(childId);
+                }
+                if(--remaining[childId] > 0) continue;
+
+                if(isSingle(child.g)) {
+                    currentLayer.push_back(childId);
+                } else {
+                    layers[layer].push_back(child.g);
+                    nextLayer.push_back(childId);
+                }
+            }
+        }
+        currentLayer.swap(nextLayer);
+        nextLayer.clear();
+    }
+
+    for(int id : touched) remaining[id] = -1;
+    touched.clear();
+}
@@ -1,25 +1,63 @@
 #include "Matrix.hpp"
 
-Matrix::Matrix(int rows, int cols) : rows(rows), cols(cols) {
-    data = new int[rows*cols];
-    for(int i = 0; i < rows*cols; i++) data[i] = 0;
+#include <algorithm>
+#include <cassert>
+
+constexpr Point Matrix::directions[4];
+
+Matrix::Matrix(int rows, int cols, std::pmr::memory_resource* memory) : memory(memory), rows(rows), cols(cols) {
+#ifdef MORTON_LAYOUT
+    int side = 1;
+    while(side < std::max(rows, cols) + 2) side *= 2;
+    assert(side <= (1 << 15)); // indices must fit in an int
+    size = side*side;
+#else
+    stride = cols + 2;
+    size = (rows + 2)*stride;
+    deltas[0] = -1;
+    deltas[1] = -stride;
+    deltas[2] = 1;
+    deltas[3] = stride;
+#endif
+    data = static_cast<int*>(memory->allocate(size*sizeof(int), alignof(int)));
+    for(int i = 0; i < size; i++) data[i] = 0;
 }
 
 Matrix::Matrix(int n) : Matrix(n, n) {}
 
-Matrix::Matrix(const Matrix& mat) : rows(mat.rows), cols(mat.cols) {
-    data = new int[rows*cols];
-    for(int i = 0; i < rows*cols; i++) data[i] = mat.data[i];
+Matrix::Matrix(const Matrix& mat, std::pmr::memory_resource* memory) :
+    memory(memory), rows(mat.rows), cols(mat.cols), size(mat.size) {
+#ifndef MORTON_LAYOUT
+    stride = mat.stride;
+    std::copy(mat.deltas, mat.deltas + 4, deltas);
+#endif
+    data = static_cast<int*>(memory->allocate(size*sizeof(int), alignof(int)));
+    for(int i = 0; i < size; i++) data[i] = mat.data[i];
 }
 
-Matrix::Matrix(Matrix&& mat) : rows(mat.rows), cols(mat.cols), data(mat.data) {
+Matrix::Matrix(Matrix&& mat) : memory(mat.memory), data(mat.data), rows(mat.rows), cols(mat.cols), size(mat.size) {
+#ifndef MORTON_LAYOUT
+    stride = mat.stride;
+    std::copy(mat.deltas, mat.deltas + 4, deltas);
+#endif
     mat.data = nullptr;
 }
 
+void Matrix::setBorder(int value) {
+    for(int i = -1; i <= rows; i++) {
+        data[index({-1, i})] = value;
+        data[index({cols, i})] = value;
+    }
+    for(int j = 0; j < cols; j++) {
+        data[index({j, -1})] = value;
+        data[index({j, rows})] = value;
+    }
+}
+
 void clear(Matrix& mat) {
     for(int i = 0; i < mat.numRows(); i++) {
         for(int j = 0; j < mat.numCols(); j++) {
-            mat[i][j] = 0;
+            mat[{j, i}] = 0;
         }
     }
 }
@@ -27,8 +65,8 @@ void clear(Matrix& mat) {
 void printMatrix(std::ostream& out, const Matrix& m) {
     for(int i = 0; i < m.numRows(); ++i) {
         for(int j = 0; j < m.numCols(); ++j) {
-            out << m[i][j] << '\t';
+            out << m[{j, i}] << '\t';
         }
         out << std::endl;
     }
-}
\ No newline at end of file
+}
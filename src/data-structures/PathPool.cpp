@@ -0,0 +1,66 @@
+#include "PathPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include "Matrix.hpp"
+
+/* ----- PathView implementation ----- */
+
+PathView::iterator& PathView::iterator::operator++() {
+    if(++i < length) {
+        int step = (steps[(i-1) >> 2] >> (((i-1) & 3) << 1)) & 3;
+        p = p + Matrix::directions[step];
+    }
+    return *this;
+}
+
+/* ----- PathPool implementation ----- */
+
+int PathPool::sizeClass(int numSteps) {
+    int numBytes = (numSteps + 3) >> 2;
+    int c = minClass;
+    while((1 << c) < numBytes) ++c;
+    return c;
+}
+
+BraidPath PathPool::store(const std::pmr::vector<Point>& path) {
+    BraidPath result;
+    if(path.empty()) return result;
+    result.start = path.front();
+    result.length = path.size();
+    if(path.size() == 1) return result; // no steps to store
+
+    // take a released block of the right size class, or carve a new one
+    int c = sizeClass(path.size() - 1);
+    if(c >= static_cast<int>(freeBlocks.size())) freeBlocks.resize(c + 1);
+    if(!freeBlocks[c].empty()) {
+        result.offset = freeBlocks[c].back();
+        freeBlocks[c].pop_back();
+    } else {
+        result.offset = bytes.size();
+        bytes.resize(bytes.size() + (1 << c));
+        peak = std::max(peak, bytes.size());
+    }
+
+    unsigned char* steps = bytes.data() + result.offset;
+    for(std::size_t i = 0; i + 1 < path.size(); ++i) {
+        int dx = path[i+1].x - path[i].x;
+        int dy = path[i+1].y - path[i].y;
+        int step = (dx == -1) ? 0 : (dy == -1) ? 1 : (dx == 1) ? 2 : 3;
+        assert(abs(dx) + abs(dy) == 1); // vertices must be adjacent
+        if((i & 3) == 0) steps[i >> 2] = 0;
+        steps[i >> 2] |= step << ((i & 3) << 1);
+    }
+    return result;
+}
+
+void PathPool::release(BraidPath& path) {
+    if(path.offset >= 0) freeBlocks[sizeClass(path.length - 1)].push_back(path.offset);
+    path = BraidPath();
+}
+
+void PathPool::clear() {
+    bytes.clear();
+    for(auto& blocks : freeBlocks) blocks.clear(); // keep their capacity for the paths stored next
+}
@@ -0,0 +1,10 @@
+#include "ReservationTable.hpp"
+
+#include <cassert>
+
+void ReservationTable::claim(const PathView& path, int until) {
+    for(const Point& p : path) {
+        assert(expiries[p] <= until); // claims are made in order of their expiry
+        expiries[p] = until;
+    }
+}
@@ -0,0 +1,38 @@
+#include "RouteMemo.hpp"
+
+#include <algorithm>
+
+RouteMemo::RouteMemo(int rows, int cols, int numGates) :
+    tileRows((rows + tileSize - 1)/tileSize),
+    tileCols((cols + tileSize - 1)/tileSize),
+    tileStamps(tileRows*tileCols, 0),
+    failures(numGates)
+{}
+
+void RouteMemo::recordFailure(int gateId, const Cell& source, const Cell& dest, const Box& region) {
+    // convert vertex box to tile box (clamped to the lattice)
+    Box tiles = {
+        { std::max(region.lo.x, 0)/tileSize, std::max(region.lo.y, 0)/tileSize },
+        { std::min(region.hi.x/tileSize, tileCols - 1), std::min(region.hi.y/tileSize, tileRows - 1) }
+    };
+    failures[gateId] = { source, dest, tiles, clock++ };
+}
+
+bool RouteMemo::shouldRetry(int gateId, const Cell& source, const Cell& dest) const {
+    if(!hasFailed(gateId)) return true;
+
+    const Failure& f = failures[gateId];
+    if(f.source.x != source.x || f.source.y != source.y || f.dest.x != dest.x || f.dest.y != dest.y) {
+        return true; // gate was remapped since it failed
+    }
+    for(int i = f.tiles.lo.y; i <= f.tiles.hi.y; ++i) {
+        for(int j = f.tiles.lo.x; j <= f.tiles.hi.x; ++j) {
+            if(tileStamps[i*tileCols + j] > f.stamp) return true;
+        }
+    }
+    return false;
+}
+
+void RouteMemo::markFreed(const Point& p) {
+    tileStamps[(p.y/tileSize)*tileCols + p.x/tileSize] = clock;
+}
@@ -2,20 +2,34 @@
 #include <chrono>
 #include <cassert>
 #include <forward_list>
+#include <memory_resource>
 #include <stack>
 #include "setutils.hpp"
+#include "alloccount.hpp"
 
 #include "config.hpp"
 #include "partition.hpp"
+#include "curveplace.hpp"
+#include "anneal.hpp"
+#include "placecache.hpp"
 #include "pathfind.hpp"
 #include "graphutils.hpp"
 #include "findswaps.hpp"
+#include "pathrepair.hpp"
+#include "spacetime.hpp"
 
 #include "Graph.hpp"
 #include "CircuitDAG.hpp"
 #include "ActiveGate.hpp"
+#include "ActiveGateQueue.hpp"
+#include "CycleArena.hpp"
 #include "Matrix.hpp"
 #include "Lattice.hpp"
+#include "FreeSpaceMap.hpp"
+#include "RouteMemo.hpp"
+#include "ReservationTable.hpp"
+#include "Landmarks.hpp"
+#include "LookaheadWindow.hpp"
 
 using std::cout;
 using std::cerr;
@@ -31,6 +45,12 @@ int main(int argc, char* argv[]) {
     int consecutiveSWAPLayers = 0; // how many times placement optimizer was used in a row
     unsigned long cumulativeVert = 0; // cumulative braiding resource usage
     unsigned long currentVert = 0; // braiding resource usage for the current cycle
+    unsigned long numSkippedSearches = 0; // braids rejected by the free space connectivity check
+    unsigned long numMemoizedFailures = 0; // braids not retried b/c nothing was freed in their region
+    unsigned long numLandmarkUpdates = 0; // landmark distance field recomputations
+    unsigned long numRoutedBraids = 0, numFailedBraids = 0; // searches that did/did not find a path
+    unsigned long routedExpansions = 0, failedExpansions = 0, maxRoutedExpansions = 0; // A* and LPA* node expansions spent on each
+    unsigned long numReservations = 0; // braids reserved to start at a future cycle
     auto startTime = std::chrono::high_resolution_clock::now();
 
     // build circuit
@@ -44,37 +64,57 @@ int main(int argc, char* argv[]) {
     while(length*length < circuit.numLogicalQubits()) ++length;
     Lattice grid (length);
     Matrix world (grid.latticeLength() + 1); // used in A* search
+    FreeSpaceMap freeSpace (world.numRows(), world.numCols()); // free components of 'world'
+    RouteMemo routeMemo (world.numRows(), world.numCols(), circuit.numGates()); // failed braids and where they searched
+    PathRepairer repairer (world.numRows(), world.numCols(), env.repairMemoryMB*(1ul << 20));
+    ReservationTable reservations (world.numRows(), world.numCols()); // when each claim in 'world' expires
+    PathPool paths; // braid paths of active gates
+    LookaheadWindow swapWindow (env.swapWindow, env.swapDecay); // upcoming layers used to score swaps
+    Landmarks landmarks (world.numRows(), world.numCols(), env.numLandmarks); // ALT heuristic for A* search
+
+    // look up a placement computed by an earlier run for the same coupling graph and options
+    // (the weighted coupling graph that keys the cache is kept for the placement itself on a miss)
+    PlacementKey placementKey;
+    bool isPlacementCached = false;
+    metisGraph weightedCoupling;
+    if(env.doInitPlacement && !env.placementCacheDir.empty()) {
+        cerr << "Looking up placement cache... ";
+        weightedCoupling = buildWeightedCouplingGraph(circuit, env.couplingDecay);
+        placementKey = makePlacementKey(weightedCoupling, grid.latticeLength(), env);
+        std::vector<int> mapping;
+        isPlacementCached = loadPlacement(env.placementCacheDir, placementKey, mapping);
+        if(isPlacementCached) grid.setMapping(std::move(mapping));
+        cerr << (isPlacementCached ? "hit " : "miss ") << placementKey.name() << endl;
+    }
 
     // initial placement
-    if(env.doInitPlacement) {
+    if(env.doInitPlacement && !isPlacementCached) {
         // create logical qubit coupling graph
+        // (the curve approach only needs the CSR form, which is much cheaper to build for large circuits)
         cerr << "Building coupling graph... ";
         Graph coupling;
-        for(int i = 0; i < circuit.numLogicalQubits(); ++i) coupling.addVertex(i);
-        auto frontLayer = circuit.getExecutableGates();
-        while(!frontLayer.empty()) {
-            for(int gateId : frontLayer) {
-                const Gate& g = circuit.get(gateId);
-                if(!isSingle(g)) coupling.addEdge(g.control, g.target);
-                circuit.resolveGate(gateId);
-            }
-            frontLayer = circuit.getExecutableGates();
-        }
-        circuit.reset(); // reset circuit so it can be parsed again in the main loop
+        if(!env.doCurvePlacement) coupling = buildCouplingGraph(circuit);
+        if((env.doWeightedCoupling || env.doCurvePlacement) && weightedCoupling.id_map.empty())
+            weightedCoupling = buildWeightedCouplingGraph(circuit, env.couplingDecay);
         cerr << "Done." << endl;
 
         cerr << "Performing initial placement... ";
         // determine which initial placement method to use
         bool isLineGraph = false;
-        int vertexId = getMaxDegreeVertexId(coupling);
-        std::vector<std::vector<int>> components;
-        if(coupling.getVertex(vertexId).degree() <= 2) {
-            components = getComponentsInOrder(coupling);
-            if(components.size() == 1) isLineGraph = true;
+        std::pmr::vector<std::pmr::vector<int>> components;
+        if(!env.doCurvePlacement) {
+            int vertexId = getMaxDegreeVertexId(coupling);
+            if(coupling.getVertex(vertexId).degree() <= 2) {
+                components = getComponentsInOrder(coupling);
+                if(components.size() == 1) isLineGraph = true;
+            }
         }
 
         std::vector<int> mapping;
-        if(isLineGraph) { // special placement approach when coupling graph is a line graph
+        if(env.doCurvePlacement) { // linear ordering of the qubits laid along a space-filling curve
+            cerr << "choosing space-filling curve approach... ";
+            mapping = curvePlacement(weightedCoupling, grid);
+        } else if(isLineGraph) { // special placement approach when coupling graph is a line graph
             cerr << "choosing line graph layout approach... ";
             auto verticesInOrder = components[0];
             mapping.resize(circuit.numLogicalQubits());
@@ -88,39 +128,145 @@ int main(int argc, char* argv[]) {
         } else { // perform graph partition and getting initial mapping
             cerr << "choosing gpmetis approach... ";
             initMetisOptions();
-            mapping = initialPlacement(coupling, grid);
+            mapping = env.doWeightedCoupling ?
+                initialPlacement(weightedCoupling, grid, env.numThreads) :
+                initialPlacement(coupling, grid, env.numThreads);
         }
         grid.setMapping(std::move(mapping));
         cerr << "Done." << endl;
+
+        if(env.doAnneal) { // refine the placement
+            cerr << "Refining placement by simulated annealing... ";
+            if(weightedCoupling.id_map.empty())
+                weightedCoupling = buildWeightedCouplingGraph(circuit, env.couplingDecay);
+            AnnealOptions annealOptions;
+            annealOptions.numChains = env.annealChains;
+            annealOptions.numThreads = env.numThreads;
+            annealOptions.sweeps = env.annealSweeps;
+            annealOptions.timeLimitMs = env.annealTimeMs;
+            annealOptions.seed = env.annealSeed;
+            long long before = wirelength(weightedCoupling, grid);
+            long long after = annealPlacement(grid, weightedCoupling, annealOptions);
+            cerr << "Done. (weighted wirelength " << before << " -> " << after << ")" << endl;
+        }
+        if(!env.placementCacheDir.empty() && !storePlacement(env.placementCacheDir, placementKey, grid.getMapping()))
+            cerr << "WARNING: could not write to placement cache " << env.placementCacheDir << endl;
     }
+    weightedCoupling = metisGraph(); // not needed while braiding
+    if(env.doInitPlacement)
+        cerr << "Coupling cost of placement (total CX distance): " << couplingCost(circuit, grid) << endl;
 
     // auxiliary data structures
-    std::forward_list<ActiveGate> activeGates;
-    std::unordered_set<int> activeGateIds; // store active gates for quick lookup
-    std::unordered_set<int> executableGates = circuit.getExecutableGates();
+    ActiveGateQueue activeGates; // gates in flight, by completion cycle
+    std::pmr::unsynchronized_pool_resource swappingNodes; // recycles the nodes of 'swappingQubits'
+    std::pmr::unordered_set<int> swappingQubits (&swappingNodes); // qubits taking part in SWAPs that overlap in-flight gates
+    std::vector<Gate> CXfrontLayer; // CX gates of the executable layer when SWAPs are scheduled (reused)
+    const std::vector<int>& executableGates = circuit.getExecutableGates(); // kept up to date by the DAG, also across SWAP layers
     std::stack<int> CXstack; // used to hold removed CX gates in the loop
+    CycleArena arena; // temporaries of the current loop iteration (reset at the start of every iteration)
+    CycleArena searchArena; // A* search state of the current braid (reset after every braid)
+
+    // SWAPs scheduled alongside in-flight gates are active gates that are not part of the circuit
+    auto isSwap = [](const ActiveGate& g) -> bool { return g.id == -1; };
+
+    // gates with more slack are set aside first when peeling the interference graph, so gates on
+    // the critical path get braided first
+    if(env.doSlackPriority) circuit.computeTiming([&](const Gate& g) { return getCost(g.name, env); });
 
     // lambdas used for the interference graph
-    auto compareArea = [&](const Graph::Vertex& v1, const Graph::Vertex& v2) -> bool {
+    auto comparePriority = [&](const Graph::Vertex& v1, const Graph::Vertex& v2) -> bool {
+        if(env.doSlackPriority) {
+            int slack1 = circuit.getSlack(v1.id);
+            int slack2 = circuit.getSlack(v2.id);
+            if(slack1 != slack2) return slack1 > slack2;
+        }
         return grid.getArea(circuit.get(v1.id)) > grid.getArea(circuit.get(v2.id));
     };
     auto isNotActive = [&](const Graph::Vertex& v) -> bool {
-        return !contains(activeGateIds, v.id);
+        return !circuit.isActive(v.id);
+    };
+
+    // braids a gate, skipping the A* search if it is known to fail:
+    // either it failed before and nothing was freed in its region since,
+    // or its cells lie in different free components
+    // the path is allocated from the loop iteration arena
+    auto route = [&](const Gate& g) -> std::pmr::vector<Point> {
+        Cell source = grid.getLatticePosition(g.control);
+        Cell dest = grid.getLatticePosition(g.target);
+        if(!routeMemo.shouldRetry(g.id, source, dest)) {
+            ++numMemoizedFailures;
+            return std::pmr::vector<Point>();
+        }
+        if(!freeSpace.mayConnect(source, dest)) {
+            ++numSkippedSearches;
+            return std::pmr::vector<Point>();
+        }
+
+        // gates that failed before are stalled; their search state is kept and repaired if enabled
+        Box explored;
+        SearchOptions options;
+        options.explored = &explored;
+        options.memory = &arena;
+        options.scratch = &searchArena;
+        if(env.numLandmarks > 0) options.landmarks = &landmarks;
+
+        // repaired braids are searched by LPA*, which counts its own expansions
+        unsigned long expansionsBefore = numExpansions() + repairer.numExpansions();
+        std::pmr::vector<Point> path (&arena);
+        if(env.doPathRepair && routeMemo.hasFailed(g.id)) path = repairer.braid(g, grid, world, &explored, &arena);
+        else if(env.windowMargin > 0) path = braidWindowed(g, grid, world, env.windowMargin, options);
+        else path = braid(g, grid, world, options);
+        searchArena.reset();
+        unsigned long expansions = numExpansions() + repairer.numExpansions() - expansionsBefore;
+        if(path.empty()) {
+            ++numFailedBraids;
+            failedExpansions += expansions;
+            routeMemo.recordFailure(g.id, source, dest, explored);
+        } else {
+            ++numRoutedBraids;
+            routedExpansions += expansions;
+            maxRoutedExpansions = std::max(maxRoutedExpansions, expansions);
+            routeMemo.forget(g.id);
+            repairer.forget(g.id);
+            for(const Point& p : path) repairer.notifyChanged(p); // vertices are about to be claimed
+        }
+        return path;
     };
 
     // enter loop
+#ifdef COUNT_ALLOCATIONS
+    unsigned long numIterations = 0;
+    unsigned long numAllocatingIterations = 0, lastAllocatingIteration = 0; // iterations that used the global heap
+    unsigned long heapAllocationsBefore = numHeapAllocations();
+    unsigned long heapAllocationsSeen = heapAllocationsBefore;
+    auto countAllocations = [&]() { // charges heap allocations since the last call to the current iteration
+        unsigned long n = numHeapAllocations();
+        if(n != heapAllocationsSeen) {
+            ++numAllocatingIterations;
+            lastAllocatingIteration = numIterations;
+        }
+        heapAllocationsSeen = n;
+    };
+#endif
     while(!activeGates.empty() || !executableGates.empty()) {
         cerr << "\rPerforming braiding (cycle " << numCycles << ")... ";
+#ifdef COUNT_ALLOCATIONS
+        countAllocations();
+        ++numIterations;
+#endif
+        arena.reset(); // everything allocated from it in the last iteration is gone
 
         // BEGIN STACK-BASED SCHEDULING SECTION
-        std::vector<Gate> CXgates; // holds the relevant CX gates for which to build the interference graph
-        std::forward_list<ActiveGate> pendingGates; // holds gates that are able to activate this cycle
+        std::pmr::vector<const Gate*> CXgates (&arena); // the relevant CX gates for which to build the interference graph
+        std::pmr::forward_list<ActiveGate> pendingGates (&arena); // holds gates that are able to activate this cycle
+        std::pmr::vector<int> stalledCX (&arena); // CX gates that could not be braided this cycle
         int numScheduledCX = 0;
 
         // separate single-qubit and two-qubit gates amongst currently executing gates
         for(const ActiveGate& g : activeGates) {
+            if(isSwap(g)) continue; // not part of the circuit
             if(!isSingle(g)) {
-                CXgates.push_back(g);
+                CXgates.push_back(&circuit.get(g.id));
                 ++numScheduledCX; // currently active gates count as scheduled gates
             }
         }
@@ -128,28 +274,39 @@ int main(int argc, char* argv[]) {
         // separate single-qubit and two-qubit gates in executable layer
         for(int gateId : executableGates) {
             const Gate& g = circuit.get(gateId);
+            if(contains(swappingQubits, g.target) || contains(swappingQubits, g.control)) continue;
             if(isSingle(g)) { // single-qubit gates can possibly be scheduled immediately
-                pendingGates.push_front(activateGate(g, std::vector<Point>(), world, env));
+                pendingGates.push_front(activateGate(g, {}, world, paths, env));
             } else {
-                CXgates.push_back(g);
+                CXgates.push_back(&g);
             }
         }
 
+        // relabel free space if any vertices were freed since the last cycle
+        freeSpace.update(world);
+
+        // recompute landmark distances once the horizon they were computed for has passed
+        // (they cover every vertex freed within it, so they stay admissible until then)
+        if(env.numLandmarks > 0 && !landmarks.isValid(numCycles)) {
+            landmarks.compute(reservations, numCycles + env.landmarkHorizon);
+            ++numLandmarkUpdates;
+        }
+
         // construct interference graph
-        Graph interferenceGraph = buildInterferenceGraph(CXgates, grid);
+        Graph interferenceGraph = buildInterferenceGraph(CXgates, grid, &arena);
 
         // remove highest interference inactive CX gates from graph and push onto the stack
         // until either max degree of inactive gates <= 2 or there are no more inactive gates
-        int interferer = getMaxDegreeVertexId(interferenceGraph, isNotActive, compareArea);
+        int interferer = getMaxDegreeVertexId(interferenceGraph, isNotActive, comparePriority);
         while(interferer != -1 && interferenceGraph.getVertex(interferer).degree() >= 3) {
             CXstack.push(interferer);
             interferenceGraph.deleteVertex(interferer);
-            interferer = getMaxDegreeVertexId(interferenceGraph, isNotActive, compareArea);
+            interferer = getMaxDegreeVertexId(interferenceGraph, isNotActive, comparePriority);
         }
 
         // remove all active gates from interference graph to enable component finding
         {
-            std::vector<int> gatesToRemove;
+            std::pmr::vector<int> gatesToRemove (&arena);
             for(const Graph::Vertex& v : interferenceGraph) {
                 if(isNotActive(v)) continue;
                 else gatesToRemove.push_back(v.id);
@@ -158,14 +315,16 @@ int main(int argc, char* argv[]) {
         }
         
         // begin finding braid paths for inactive CX gates remaining in the interference graph
-        auto components = getComponentsInOrder(interferenceGraph);
-        for(auto component : components) {
+        auto components = getComponentsInOrder(interferenceGraph, &arena);
+        for(const auto& component : components) {
             for(int id : component) {
                 const Gate& g = circuit.get(id);
-                std::vector<Point> path = braid(g, grid, world);
+                std::pmr::vector<Point> path = route(g);
                 if(!path.empty()) {
-                    pendingGates.push_front(activateGate(g, std::move(path), world, env));
+                    pendingGates.push_front(activateGate(g, path, world, paths, env));
                     ++numScheduledCX;
+                } else {
+                    stalledCX.push_back(id);
                 }
             }
         }
@@ -175,10 +334,12 @@ int main(int argc, char* argv[]) {
             int id = CXstack.top();
             CXstack.pop();
             const Gate& g = circuit.get(id);
-            std::vector<Point> path = braid(g, grid, world);
+            std::pmr::vector<Point> path = route(g);
             if(!path.empty()) {
-                pendingGates.push_front(activateGate(g, std::move(path), world, env));
+                pendingGates.push_front(activateGate(g, path, world, paths, env));
                 ++numScheduledCX;
+            } else {
+                stalledCX.push_back(id);
             }
         }
 
@@ -190,89 +351,163 @@ int main(int argc, char* argv[]) {
                 ++consecutiveSWAPLayers;
                 // assert(consecutiveSWAPLayers <= env.maxConsecutiveSWAPLayers);
 
-                // wait for currently active gates to finish and reset everything
-                int numTicks = 0;
-                for(const ActiveGate& g : activeGates) {
-                    cumulativeVert += (g.cycleCost - g.lifetime)*g.braidPath.size(); // debug
-                    numTicks = std::max(numTicks, g.cycleCost - g.lifetime);
-                    circuit.resolveGate(g.id);
+                std::pmr::unordered_set<int> busyQubits (&arena); // qubits that cannot be swapped
+                if(env.doSwapOverlap) {
+                    // route swaps around in-flight gates instead of waiting for them to finish;
+                    // pending gates are not officially activated, so give back the vertices they took
+                    for(ActiveGate& g : pendingGates) {
+                        deactivateGate(g, world, paths);
+                        for(const Point& p : paths.view(g.braidPath)) {
+                            routeMemo.markFreed(p);
+                            repairer.notifyChanged(p);
+                        }
+                        paths.release(g.braidPath);
+                    }
+                    freeSpace.invalidate();
+                    pendingGates.clear();
+                    stalledCX.clear(); // do not reserve braids ahead of the swaps either
+                    for(const ActiveGate& g : activeGates) {
+                        busyQubits.insert(g.target); // every gate occupies its target
+                        if(!isSingle(g)) busyQubits.insert(g.control);
+                    }
+                } else {
+                    // wait for currently active gates to finish and reset everything
+                    int numTicks = 0;
+                    for(const ActiveGate& g : activeGates) {
+                        cumulativeVert += (g.finishCycle - numCycles)*g.braidPath.size(); // debug
+                        numTicks = std::max(numTicks, g.finishCycle - numCycles);
+                        circuit.resolveGate(g.id);
+                    }
+                    numCycles += numTicks;
+                    clear(world);
+                    reservations.reset();
+                    landmarks.invalidate();
+                    freeSpace.invalidate();
+                    routeMemo.markAllFreed();
+                    repairer.notifyCleared();
+                    paths.clear();
+                    activeGates.clear();
+                    pendingGates.clear(); // do not officially active pending gates
+                    currentVert = 0;
                 }
-                numCycles += numTicks;
-                clear(world);
-                activeGateIds.clear();
-                activeGates.clear();
-                pendingGates.clear(); // do not officially active pending gates
-                currentVert = 0;
 
                 // determine front layer of CX gates and schedule swaps
-                auto frontLayer = circuit.getExecutableGates();
-                std::vector<Gate> CXfrontLayer;
+                const std::vector<int>& frontLayer = circuit.getExecutableGates();
+                CXfrontLayer.clear();
                 for(int id : frontLayer) {
                     const Gate& g = circuit.get(id);
                     if(!isSingle(g)) CXfrontLayer.push_back(g);
                 }
                 int numSWAPVertices;
-                int numSwaps = findSwaps(CXfrontLayer, grid, world, numSWAPVertices);
+                std::pmr::vector<SwapBraid> swapBraids (&arena);
+                SwapOptions swapOptions;
+                swapOptions.numThreads = env.numThreads;
+                swapOptions.memory = &arena;
+                swapOptions.scratch = &searchArena;
+                if(env.swapWindow > 0) {
+                    swapWindow.update(circuit);
+                    swapOptions.window = &swapWindow;
+                }
+                if(env.doSwapOverlap) {
+                    swapOptions.excludedQubits = &busyQubits;
+                    swapOptions.braids = &swapBraids;
+                }
+                int numSwaps = findSwaps(CXfrontLayer, grid, world, numSWAPVertices, swapOptions);
 
                 if(numSwaps == 0) {
                     cerr << "activated placement optimizer but 0 SWAPs inserted." << endl; // debug
-                } else {
+                } else if(!env.doSwapOverlap) {
                     numCycles += getCost("swap", env); // SWAPs cost 3 CX gates
                     cumulativeVert += numSWAPVertices*getCost("swap", env); // debug
                 }
-
-                continue; // do not enter cycle update section
+                if(!env.doSwapOverlap) continue; // do not enter cycle update section
+
+                // swaps execute as active gates alongside in-flight gates; their qubits wait until they finish
+                for(const SwapBraid& b : swapBraids) {
+                    for(const Point& p : b.path) repairer.notifyChanged(p);
+                    ActiveGate swap = activateGate(b.swap, b.path, world, paths, env);
+                    currentVert += swap.braidPath.size(); // debug
+                    reservations.claim(paths.view(swap.braidPath), numCycles + swap.cycleCost);
+                    swappingQubits.insert({ b.swap.control, b.swap.target });
+                    activeGates.push(swap, numCycles);
+                }
+                if(activeGates.empty()) continue; // nothing to tick forward
             } else {
                 consecutiveSWAPLayers = 0;
             }
         }
 
         // else, officially activate pending gates
-        for(auto root = pendingGates.before_begin(); !pendingGates.empty();) {
-            auto front = root; ++front; // get front of list
-            currentVert += front->braidPath.size(); // debug
-            circuit.activateGate(front->id); // remove gate from executable layer in DAG
-            activeGateIds.insert(front->id); // add id to lookup table
-            activeGates.splice_after(activeGates.before_begin(), pendingGates, root); // add gate to activeGate list
+        for(ActiveGate& g : pendingGates) {
+            currentVert += g.braidPath.size(); // debug
+            reservations.claim(paths.view(g.braidPath), numCycles + g.cycleCost);
+            circuit.activateGate(g.id); // move gate from the executable layer to the active gates in DAG
+            activeGates.push(std::move(g), numCycles); // add gate to activeGate queue
+        }
+        pendingGates.clear();
+
+        // reserve braids for stalled CX gates that can start within the look-ahead window,
+        // so they start as soon as their path is released instead of waiting to be retried
+        if(env.lookahead > 0) {
+            for(int id : stalledCX) {
+                const Gate& g = circuit.get(id);
+                int start;
+                std::pmr::vector<Point> path = braidSpaceTime(
+                    g, grid, reservations, numCycles, env.lookahead, start, &arena, &searchArena
+                );
+                searchArena.reset();
+                if(path.empty()) continue;
+
+                for(const Point& p : path) {
+                    if(world[p] == 0) ++currentVert; // debug (vertices still held by other gates are counted already)
+                    repairer.notifyChanged(p);
+                }
+                ActiveGate reserved = reserveGate(g, path, start - numCycles, world, paths, env);
+                reservations.claim(paths.view(reserved.braidPath), start + reserved.cycleCost);
+                routeMemo.forget(id);
+                repairer.forget(id);
+
+                circuit.activateGate(id);
+                activeGates.push(std::move(reserved), numCycles);
+                ++numReservations;
+            }
         }
         // END STACK-BASED SCHEDULING SECTION
         
         // BEGIN CYCLE UPDATE SECTION
         assert(!activeGates.empty());
         // determine how many cycles to tick forward (minimum to make an active gate finish)
-        int numTicks = std::numeric_limits<int>::max();
-        for(const ActiveGate& g : activeGates) {
-            numTicks = std::min(numTicks, g.cycleCost - g.lifetime);
-        }
+        int numTicks = activeGates.nextCompletion() - numCycles;
 
         // tick forward
         numCycles += numTicks;
         cumulativeVert += currentVert*numTicks;
 
-        // update active gate lifetimes and see if any have completed
-        for(auto prev = activeGates.before_begin(), current = activeGates.begin();
-            current != activeGates.end();
-            prev = current++
-        ) {
-            current->lifetime += numTicks;
-            if(isDone(*current)) {
-                // resolve completed gate
-                currentVert -= current->braidPath.size();
-                deactivateGate(*current, world);
-                circuit.resolveGate(current->id);
-
-                assert(contains(activeGateIds, current->id));
-                // remove from activeGates list and lookup table
-                activeGateIds.erase(current->id);
-                activeGates.erase_after(prev);
-                current = prev;
+        // retire the gates that have completed
+        while(activeGates.hasCompleted(numCycles)) {
+            ActiveGate g = activeGates.popCompleted();
+            deactivateGate(g, world, paths);
+            freeSpace.invalidate();
+            for(const Point& p : paths.view(g.braidPath)) {
+                if(world[p] == 0) --currentVert; // vertex may still be reserved by another gate
+                routeMemo.markFreed(p);
+                repairer.notifyChanged(p);
+            }
+            paths.release(g.braidPath);
+            if(isSwap(g)) {
+                swappingQubits.erase(g.control);
+                swappingQubits.erase(g.target);
+            } else {
+                assert(circuit.isActive(g.id));
+                circuit.resolveGate(g.id);
             }
         }
         // END CYCLE UPDATE SECTION
-
-        // while-loop updates
-        executableGates = circuit.getExecutableGates();
     }
+#ifdef COUNT_ALLOCATIONS
+    countAllocations();
+    unsigned long numLoopAllocations = numHeapAllocations() - heapAllocationsBefore;
+#endif
     cerr << "Done.\n" << endl;
 
     // calculation total computation time
@@ -291,6 +526,31 @@ int main(int argc, char* argv[]) {
     cout << "surface code distance: " << env.d << endl;
     cout << "logical error rate (-log(PL)): " << d2logPL(env.d) << endl;
     cout << "resource utilization: " << resUtil << endl;;
+    cout << "A* searches: " << numSearches() << " (" << numExpansions() << " node expansions, "
+         << static_cast<double>(numExpansions())/std::max(numSearches(), 1ul) << " per search)" << endl;
+    cout << "braids routed: " << numRoutedBraids << " ("
+         << static_cast<double>(routedExpansions)/std::max(numRoutedBraids, 1ul) << " node expansions each, "
+         << maxRoutedExpansions << " at most)" << endl;
+    cout << "braids not routed: " << numFailedBraids << " ("
+         << static_cast<double>(failedExpansions)/std::max(numFailedBraids, 1ul) << " node expansions each)" << endl;
+    cout << "A* searches skipped (disconnected free space): " << numSkippedSearches << endl;
+    cout << "A* searches skipped (memoized failures): " << numMemoizedFailures << endl;
+    if(env.numLandmarks > 0) cout << "landmark recomputations: " << numLandmarkUpdates << endl;
+    if(env.lookahead > 0) cout << "braids reserved ahead of time: " << numReservations << endl;
+    cout << "braid path storage (peak): " << paths.peakBytes() << " bytes" << endl;
+#ifdef COUNT_ALLOCATIONS
+    cout << "heap allocations while braiding: " << numLoopAllocations << " ("
+         << static_cast<double>(numLoopAllocations)/std::max(numIterations, 1ul) << " per loop iteration, "
+         << numIterations << " iterations)" << endl;
+    cout << "loop iterations that allocated: " << numAllocatingIterations << " (the last was iteration "
+         << lastAllocatingIteration << ")" << endl;
+    cout << "loop iteration arena: " << arena.capacity() << " bytes, search arena: " << searchArena.capacity() << " bytes" << endl;
+#endif
+    if(env.doPathRepair) {
+        cout << "stalled braids repaired incrementally: " << repairer.numRepairs() << endl;
+        cout << "stalled braids searched from scratch: " << repairer.numFreshSearches() << endl;
+        cout << "LPA* node expansions: " << repairer.numExpansions() << endl;
+    }
     cout << "scheduled circuit runtime: " << numCycles << " cycles" << endl;
     cout << "                           " << numCycles*env.timePerCycle << " microseconds" << endl;
     if(env.isQFT) { // compute formula for maslov's approach
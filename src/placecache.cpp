@@ -0,0 +1,98 @@
+#include <iostream>
+#include <filesystem>
+#include <string>
+
+#include "cxxopts.hpp"
+#include "placecache.hpp"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// inspects and maintains a placement cache directory written by 'autobraid --place-cache'
+int main(int argc, char* argv[]) {
+    std::string dir, showName, removeName;
+    bool doClear = false;
+
+    try {
+        cxxopts::Options options (argv[0], "inspect an autobraid placement cache");
+        options
+            .set_width(100)
+            .positional_help("<cacheDir>")
+            .show_positional_help()
+        ;
+        options.add_options()
+            ("show", "print the mapping of an entry", cxxopts::value<std::string>(showName))
+            ("remove", "delete an entry", cxxopts::value<std::string>(removeName))
+            ("clear", "delete all entries (and temporary files left by interrupted stores)",
+                cxxopts::value<bool>(doClear)->default_value("false"))
+        ;
+        options.add_options("detail")
+            ("dir", "cache directory", cxxopts::value<std::string>(dir))
+        ;
+        options.parse_positional("dir");
+
+        if(argc == 1) {
+            cout << options.help({""});
+            return 0;
+        }
+        auto result = options.parse(argc, argv);
+        if(result.count("dir") != 1) {
+            cerr << "Exactly one cache directory must be input." << endl;
+            return 1;
+        }
+    } catch(const cxxopts::OptionException& e) {
+        cerr << "parse error: " << e.what() << endl;
+        return 1;
+    }
+
+    // entries are named after their key, so a name resolves to a path directly
+    auto findEntry = [&](const std::string& name) -> std::string {
+        for(const std::string& path : listPlacementEntries(dir)) {
+            if(std::filesystem::path(path).stem() == name) return path;
+        }
+        cerr << "no entry named " << name << " in " << dir << endl;
+        exit(1);
+    };
+
+    if(!showName.empty()) {
+        PlacementEntry entry;
+        if(!readPlacementEntry(findEntry(showName), entry)) {
+            cerr << "entry " << showName << " is not readable" << endl;
+            return 1;
+        }
+        cout << "algorithm version: " << entry.key.algorithm << endl;
+        cout << "graph hash: " << std::hex << entry.key.graphHash << std::dec << endl;
+        cout << "qubits: " << entry.key.numQubits << endl;
+        cout << "lattice length: " << entry.key.latticeLength << endl;
+        cout << "options: " << entry.key.options << endl;
+        for(int q = 0; q < entry.key.numQubits; ++q) {
+            int phys = entry.mapping[q];
+            cout << q << " -> (" << phys%entry.key.latticeLength << ", " << phys/entry.key.latticeLength << ")" << endl;
+        }
+    } else if(!removeName.empty()) {
+        std::filesystem::remove(findEntry(removeName));
+    } else if(doClear) {
+        for(const std::string& path : listPlacementEntries(dir)) std::filesystem::remove(path);
+        for(const std::string& path : listTemporaryFiles(dir)) std::filesystem::remove(path);
+    } else { // list entries
+        int numEntries = 0;
+        for(const std::string& path : listPlacementEntries(dir)) {
+            PlacementEntry entry;
+            std::string name = std::filesystem::path(path).stem().string();
+            if(!readPlacementEntry(path, entry)) {
+                cout << name << "  (unreadable)" << endl;
+                continue;
+            }
+            cout << name << "  algorithm " << entry.key.algorithm << "  qubits " << entry.key.numQubits << "  length " << entry.key.latticeLength
+                 << "  options " << entry.key.options << endl;
+            ++numEntries;
+        }
+        cout << numEntries << " entries" << endl;
+        for(const std::string& path : listTemporaryFiles(dir)) {
+            cout << std::filesystem::path(path).filename().string() << "  (temporary file)" << endl;
+        }
+    }
+
+    return 0;
+}
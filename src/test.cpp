@@ -1,13 +1,13 @@
 #include <iostream>
+#include <iomanip>
+#include <algorithm>
 #include <cassert>
-#include <forward_list>
-#include <stack>
+#include <string>
+#include <vector>
 
-#include "setutils.hpp"
 #include "config.hpp"
+#include "critpath.hpp"
 #include "CircuitDAG.hpp"
-#include "Matrix.hpp"
-#include "Graph.hpp"
 #include "ActiveGate.hpp"
 
 using std::cout;
@@ -18,43 +18,61 @@ int main(int argc, char* argv[]) {
     // parse command line options and configure environment
     auto env = parse(argc, argv);
 
-    int numCycles = 0;
-
     // build circuit
-    CircuitDAG circuit (argv[1]);
+    CircuitDAG circuit (env.fileName);
     circuit.build();
 
     cout << "num qubits used: " << circuit.numLogicalQubits() << endl;
     cout << "num gates: " << circuit.numGates() << endl;
 
-    // placeholder matrix
-    Matrix world (10);
-
-    std::forward_list<ActiveGate> activeGates;
-    while(!activeGates.empty() || !circuit.getExecutableGates().empty()) {
-        for(int gateId : circuit.getExecutableGates()) {
-            ActiveGate g = activateGate(circuit.get(gateId), std::vector<Point>(), world, env);
-            activeGates.push_front(g);
-            circuit.activateGate(gateId);
+    // tabulate the critical path over a range of distances
+    if(!env.sweepDistances.empty()) {
+        std::vector<long long> sweep = criticalPathSweep(circuit, env, env.sweepDistances);
+        cout << std::setw(6) << "d" << std::setw(12) << "-log(PL)"
+             << std::setw(14) << "cycles" << std::setw(18) << "microseconds" << endl;
+        for(std::size_t k = 0; k < sweep.size(); ++k) {
+            cout << std::setw(6) << env.sweepDistances[k]
+                 << std::setw(12) << std::fixed << std::setprecision(3) << d2logPL(env.sweepDistances[k])
+                 << std::setw(14) << sweep[k]
+                 << std::setw(18) << std::setprecision(1) << sweep[k]*env.timePerCycle << endl;
         }
+        cout << std::defaultfloat << std::setprecision(6);
+        return 0;
+    }
 
-        // increment cycle by one
-        ++numCycles;
+    long long numCycles = criticalPath(circuit, env);
 
-        // update active gate lifetimes and see if any have completed
-        for(auto prev = activeGates.before_begin(), current = activeGates.begin();
-            current != activeGates.end(); prev = current++
-        ) {
-            ++current->lifetime;
-            if(isDone(*current)) {
-                // resolve completed gate
-                deactivateGate(*current, world);
-                circuit.resolveGate(current->id);
+    // compare against a simulation of the circuit's execution
+    if(env.doCrossCheck) {
+        long long simulatedCycles = criticalPathEventDriven(circuit, env);
+        cout << "event-driven simulation gives " << simulatedCycles << " cycles" << endl;
+        if(simulatedCycles != numCycles) {
+            cerr << "ERROR: critical path mismatch (" << numCycles << " vs " << simulatedCycles << " cycles)" << endl;
+            return 1;
+        }
+    }
 
-                // remove from activeGates list
-                activeGates.erase_after(prev);
-                current = prev;
-            }
+    // distribution of how far gates can be delayed without lengthening the critical path
+    if(env.slackBuckets > 0) {
+        circuit.computeTiming([&](const Gate& g) { return getCost(g.name, env); });
+        assert(circuit.getCriticalPathLength() == numCycles);
+        int maxSlack = 0;
+        for(int id = 0; id < circuit.numGates(); ++id) maxSlack = std::max(maxSlack, circuit.getSlack(id));
+        int width = maxSlack/env.slackBuckets + 1; // bucket i holds slack in [i*width, (i+1)*width)
+        std::vector<int> allCounts (env.slackBuckets), cxCounts (env.slackBuckets);
+        int numCritical = 0;
+        for(int id = 0; id < circuit.numGates(); ++id) {
+            int slack = circuit.getSlack(id);
+            if(slack == 0) ++numCritical;
+            ++allCounts[slack/width];
+            if(!isSingle(circuit.get(id))) ++cxCounts[slack/width];
+        }
+        cout << "gates on the critical path (zero slack): " << numCritical << endl;
+        cout << "slack histogram (cycles):" << endl;
+        cout << std::setw(24) << "slack" << std::setw(12) << "gates" << std::setw(12) << "cx gates" << endl;
+        for(int i = 0; i < env.slackBuckets; ++i) {
+            std::string range = "[" + std::to_string(i*width) + ", " + std::to_string((i+1)*width) + ")";
+            cout << std::setw(24) << range << std::setw(12) << allCounts[i] << std::setw(12) << cxCounts[i] << endl;
         }
     }
 
@@ -62,4 +80,4 @@ int main(int argc, char* argv[]) {
     cout << "critical path is " << numCycles << " cycles" << endl;
     cout << "critical path is " << numCycles*env.timePerCycle << " microseconds" << endl;
     return 0;
-}
\ No newline at end of file
+}
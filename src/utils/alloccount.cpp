@@ -0,0 +1,27 @@
+#include "alloccount.hpp"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long> allocationCount (0);
+
+// the array and nothrow forms of operator new call this one by default
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if(void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+
+unsigned long numHeapAllocations() { return allocationCount; }
+
+#else
+
+unsigned long numHeapAllocations() { return 0; }
+
+#endif
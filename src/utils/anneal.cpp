@@ -0,0 +1,199 @@
+#include "anneal.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include "parallel.hpp"
+
+/* ----- private helper functions ----- */
+
+static int distance(const Cell& a, const Cell& b) {
+    return abs(a.x - b.x) + abs(a.y - b.y);
+}
+
+// one annealing chain working on its own copy of the lattice
+// free cells are occupied by placeholder qubits (ids past the coupled ones, w/o edges), so every move
+// is a Lattice::swapLogicalQubit()
+class AnnealChain {
+public:
+    AnnealChain(const Lattice& grid, const metisGraph& coupling, unsigned seed) :
+        coupling(coupling), lattice(grid.latticeLength()), rng(seed)
+    {
+        int numCells = grid.latticeLength()*grid.latticeLength();
+        std::vector<int> mapping = grid.getMapping();
+        numQubits = mapping.size();
+        phys2log.assign(numCells, -1);
+        for(int q = 0; q < numQubits; ++q) phys2log[mapping[q]] = q;
+        for(int phys = 0; phys < numCells; ++phys) {
+            if(phys2log[phys] != -1) continue;
+            phys2log[phys] = mapping.size();
+            mapping.push_back(phys);
+        }
+        lattice.setMapping(std::move(mapping));
+
+        for(int q = 0; q < numQubits; ++q) {
+            if(coupling.xadj[q+1] > coupling.xadj[q]) coupled.push_back(q);
+        }
+        cost = wirelength(coupling, lattice);
+        bestCost = cost;
+        best = lattice.getMapping();
+    }
+
+    // 'sweeps' moves per coupled qubit (qubits without edges are never moved themselves)
+    void run(int sweeps, int timeLimitMs) {
+        if(coupled.empty()) return;
+        long long numMoves = static_cast<long long>(sweeps)*coupled.size();
+        auto start = std::chrono::steady_clock::now();
+
+        // start at the average uphill cost change of random moves, so the initial placement is mostly kept,
+        // and cool geometrically to a near-greedy temperature
+        double startTemp = 0;
+        int numUphill = 0;
+        for(int i = 0; i < 256; ++i) {
+            int a, b;
+            proposeMove(1.0, a, b);
+            long long delta = moveDelta(a, b);
+            if(delta > 0) {
+                startTemp += delta;
+                ++numUphill;
+            }
+        }
+        if(numUphill == 0) return;
+        startTemp /= numUphill;
+        double temp = startTemp;
+        double cooling = pow(1e-3, 1.0/numMoves);
+
+        for(long long move = 0; move < numMoves; ++move) {
+            temp *= cooling;
+            int a, b;
+            proposeMove(temp/startTemp, a, b);
+            long long delta = moveDelta(a, b);
+            if(delta <= 0 || uniform() < exp(-delta/temp)) {
+                applyMove(a, b);
+                cost += delta;
+            }
+
+            if((move & 1023) == 1023) {
+                keepIfBest();
+                if(timeLimitMs > 0) {
+                    auto elapsed = std::chrono::steady_clock::now() - start;
+                    if(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= timeLimitMs) break;
+                }
+            }
+        }
+        keepIfBest();
+    }
+
+    long long getBestCost() const { return bestCost; }
+
+    // best mapping found, restricted to the actual qubits
+    std::vector<int> getBestMapping() const {
+        return std::vector<int>(best.begin(), best.begin() + numQubits);
+    }
+
+private:
+    const metisGraph& coupling;
+    Lattice lattice;
+    std::vector<int> phys2log;
+    std::vector<int> coupled; // qubits with at least one edge
+    int numQubits;
+    long long cost, bestCost;
+    std::vector<int> best;
+    std::mt19937_64 rng;
+
+    // integer draws use plain modulo, since std distributions differ between standard libraries
+    int randomInt(int n) { return rng() % n; }
+    double uniform() { return (rng() >> 11) * (1.0/9007199254740992.0); }
+
+    // move a random coupled qubit 'a' to a random cell near one of its neighbours, swapping it with
+    // the qubit 'b' there; the neighbourhood shrinks from an eighth of the lattice to one cell as it cools
+    void proposeMove(double heat, int& a, int& b) {
+        int length = lattice.latticeLength();
+        int radius = std::max(1, static_cast<int>(heat*length/8));
+        do {
+            a = coupled[randomInt(coupled.size())];
+            int degree = coupling.xadj[a+1] - coupling.xadj[a];
+            int neighbour = coupling.adjncy[coupling.xadj[a] + randomInt(degree)];
+            Cell c = lattice.getLatticePosition(neighbour);
+            c.x = std::min(std::max(c.x + randomInt(2*radius + 1) - radius, 0), length - 1);
+            c.y = std::min(std::max(c.y + randomInt(2*radius + 1) - radius, 0), length - 1);
+            b = phys2log[lattice.getPhysQubitNumber(c)];
+        } while(a == b);
+    }
+
+    // change in wirelength if a and b swapped places
+    long long moveDelta(int a, int b) const {
+        Cell posA = lattice.getLatticePosition(a);
+        Cell posB = lattice.getLatticePosition(b);
+        long long delta = 0;
+        auto addEdges = [&](int q, int other, const Cell& from, const Cell& to) {
+            if(q >= numQubits) return; // placeholders have no edges
+            for(idx_t e = coupling.xadj[q]; e < coupling.xadj[q+1]; ++e) {
+                int v = coupling.adjncy[e];
+                if(v == other) continue; // the distance between a and b does not change
+                Cell pos = lattice.getLatticePosition(v);
+                delta += coupling.adjwgt[e]*(distance(to, pos) - distance(from, pos));
+            }
+        };
+        addEdges(a, b, posA, posB);
+        addEdges(b, a, posB, posA);
+        return delta;
+    }
+
+    void applyMove(int a, int b) {
+        int physA = lattice.getMapping()[a];
+        int physB = lattice.getMapping()[b];
+        lattice.swapLogicalQubit(a, b);
+        phys2log[physA] = b;
+        phys2log[physB] = a;
+    }
+
+    void keepIfBest() {
+        if(cost >= bestCost) return;
+        bestCost = cost;
+        best = lattice.getMapping();
+    }
+};
+
+/* ----- header function implementations ----- */
+
+long long wirelength(const metisGraph& coupling, const Lattice& grid) {
+    long long total = 0;
+    int n = coupling.xadj.size() - 1;
+    for(int v = 0; v < n; ++v) {
+        assert(coupling.id_map[v] == v);
+        Cell pos = grid.getLatticePosition(v);
+        for(idx_t e = coupling.xadj[v]; e < coupling.xadj[v+1]; ++e) {
+            int u = coupling.adjncy[e];
+            if(u < v) continue; // count each edge once
+            idx_t w = coupling.adjwgt.empty() ? 1 : coupling.adjwgt[e];
+            total += w*distance(pos, grid.getLatticePosition(u));
+        }
+    }
+    return total;
+}
+
+long long annealPlacement(Lattice& grid, const metisGraph& coupling, const AnnealOptions& options) {
+    assert(!coupling.adjwgt.empty());
+    assert(static_cast<int>(grid.getMapping().size()) == static_cast<int>(coupling.xadj.size()) - 1);
+
+    // chains are independent, so the winner does not depend on how they are spread over threads
+    std::vector<long long> costs (std::max(options.numChains, 0));
+    std::vector<std::vector<int>> mappings (costs.size());
+    parallelFor(options.numChains, options.numThreads, [&](int i) {
+        AnnealChain chain (grid, coupling, options.seed + i);
+        chain.run(options.sweeps, options.timeLimitMs);
+        costs[i] = chain.getBestCost();
+        mappings[i] = chain.getBestMapping();
+    });
+
+    long long original = wirelength(coupling, grid);
+    if(options.numChains <= 0) return original;
+    int winner = std::min_element(costs.begin(), costs.end()) - costs.begin();
+    if(costs[winner] >= original) return original;
+    grid.setMapping(std::move(mappings[winner]));
+    return costs[winner];
+}
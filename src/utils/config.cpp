@@ -21,6 +21,7 @@ Environment parse(int argc, char* argv[]) {
         ;
 
         double logInvPL = -1; // 1/pL
+        std::vector<double> sweepLogInvPL; // targets for the critical path sweep
 
         options.add_options("parameter")
             ("d,distance", "specify surface code distance",
@@ -33,14 +34,62 @@ Environment parse(int argc, char* argv[]) {
                 cxxopts::value<double>(env.swapThreshold)->default_value(".10"))
             ("max-swaps", "specify maximum swap layers allowed in a row",
                 cxxopts::value<int>(env.maxConsecutiveSWAPLayers)->default_value("10"))
+            ("swap-window", "specify number of upcoming DAG layers used to score swaps",
+                cxxopts::value<int>(env.swapWindow)->default_value("0"))
+            ("swap-decay", "specify weight decay per upcoming layer when scoring swaps",
+                cxxopts::value<double>(env.swapDecay)->default_value("0.5"))
+            ("window", "specify initial margin of windowed A* search (0 disables)",
+                cxxopts::value<int>(env.windowMargin)->default_value("0"))
+            ("landmarks", "specify number of landmarks for ALT heuristic in A* search (0 disables)",
+                cxxopts::value<int>(env.numLandmarks)->default_value("0"))
+            ("landmark-horizon", "specify how many cycles landmark distances are reused before being recomputed",
+                cxxopts::value<int>(env.landmarkHorizon)->default_value("25"))
+            ("lookahead", "specify how many cycles ahead braids may be reserved (0 disables)",
+                cxxopts::value<int>(env.lookahead)->default_value("0"))
+            ("repair-mem", "specify memory budget for path repair search states (MB)",
+                cxxopts::value<int>(env.repairMemoryMB)->default_value("256"))
+            ("coupling-decay", "specify weight of last vs first CX gates in weighted coupling graph",
+                cxxopts::value<double>(env.couplingDecay)->default_value("1"))
+            ("anneal-chains", "specify number of annealing chains for placement refinement",
+                cxxopts::value<int>(env.annealChains)->default_value("4"))
+            ("anneal-sweeps", "specify annealing moves per chain, per coupled qubit",
+                cxxopts::value<int>(env.annealSweeps)->default_value("200"))
+            ("anneal-ms", "specify time budget per annealing chain in ms (0 disables)",
+                cxxopts::value<int>(env.annealTimeMs)->default_value("0"))
+            ("anneal-seed", "specify random seed for placement refinement",
+                cxxopts::value<unsigned>(env.annealSeed)->default_value("1"))
+            ("place-cache", "specify directory to cache initial placements in (w/ --init-place)",
+                cxxopts::value<std::string>(env.placementCacheDir))
+            ("sweep-d", "specify comma-separated distances to tabulate the critical path for (critpath only)",
+                cxxopts::value<std::vector<int>>(env.sweepDistances))
+            ("sweep-p", "specify comma-separated -log(PL) targets to tabulate the critical path for (critpath only)",
+                cxxopts::value<std::vector<double>>(sweepLogInvPL))
+            ("slack-hist", "specify number of buckets of per-gate slack histogram (critpath only, 0 disables)",
+                cxxopts::value<int>(env.slackBuckets)->default_value("0"))
+            ("threads", "specify number of threads used for parallel phases",
+                cxxopts::value<int>(env.numThreads)->default_value("1"))
         ;
         options.add_options("algorithm config")
             ("init-place", "toggle gpmetis initial placement",
                 cxxopts::value<bool>(env.doInitPlacement)->default_value("false"))
+            ("curve-place", "toggle space-filling curve layout for initial placement (w/ --init-place)",
+                cxxopts::value<bool>(env.doCurvePlacement)->default_value("false"))
+            ("weighted-coupling", "toggle interaction-weighted coupling graph (w/ --init-place)",
+                cxxopts::value<bool>(env.doWeightedCoupling)->default_value("false"))
+            ("anneal", "toggle simulated annealing refinement of initial placement (w/ --init-place)",
+                cxxopts::value<bool>(env.doAnneal)->default_value("false"))
             ("swap-opt", "toggle swap-based placement optimizer",
                 cxxopts::value<bool>(env.doSwapOptimizer)->default_value("false"))
+            ("swap-overlap", "toggle swap layers that overlap in-flight gates (w/ --swap-opt)",
+                cxxopts::value<bool>(env.doSwapOverlap)->default_value("false"))
+            ("slack-priority", "toggle prioritizing gates with less slack (ie closer to the critical path)",
+                cxxopts::value<bool>(env.doSlackPriority)->default_value("false"))
             ("qft", "enable specialized code for qft circuits",
                 cxxopts::value<bool>(env.isQFT)->default_value("false"))
+            ("cross-check", "toggle event-driven simulation to cross-check critpath results (critpath only)",
+                cxxopts::value<bool>(env.doCrossCheck)->default_value("false"))
+            ("repair", "toggle incremental (LPA*) path repair for stalled gates",
+                cxxopts::value<bool>(env.doPathRepair)->default_value("false"))
         ;
         options.add_options("detail") // hidden options do not appear in help screen
             ("input", "input file name", cxxopts::value<std::string>(env.fileName))
@@ -72,6 +121,15 @@ Environment parse(int argc, char* argv[]) {
             }
         }
 
+        // the sweep covers the distances needed for all -log(PL) targets as well
+        for(double target : sweepLogInvPL) env.sweepDistances.push_back(logPL2d(target));
+
+        // gate weights are decay^(i/n), which is undefined (NaN) for non-positive decays
+        if(env.couplingDecay <= 0) {
+            cerr << "--coupling-decay must be positive (got " << env.couplingDecay << ")." << endl;
+            exit(1);
+        }
+
         // emit warning for --qft option
         if(env.isQFT) {
             cerr << "WARNING (--qft enabled): code currently does not check that "
@@ -0,0 +1,86 @@
+#include "critpath.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ActiveGate.hpp"
+#include "ActiveGateQueue.hpp"
+
+long long criticalPath(const CircuitDAG& circuit, const Environment& env) {
+    // gate ids follow the order of the circuit file, so parents always come before their children
+    std::vector<long long> start (circuit.numGates(), 0); // earliest start cycle of each gate
+    long long length = 0;
+    for(int id = 0; id < circuit.numGates(); ++id) {
+        const CircuitDAG::GateNode& node = circuit.getNode(id);
+        long long finish = start[id] + getCost(node.g.name, env);
+        length = std::max(length, finish);
+
+        int childIdList[2] = { node.controlChildId, node.targetChildId };
+        for(int childId : childIdList) {
+            if(childId != -1) start[childId] = std::max(start[childId], finish);
+        }
+    }
+    return length;
+}
+
+std::vector<long long> criticalPathSweep(const CircuitDAG& circuit, const Environment& env, const std::vector<int>& distances) {
+    int numDistances = distances.size();
+
+    // cost = intercept + slope*d, derived from getCost() once per gate name
+    struct AffineCost { long long intercept, slope; };
+    std::unordered_map<std::string, AffineCost> costs;
+    auto getAffineCost = [&](const std::string& name) -> const AffineCost& {
+        auto it = costs.find(name);
+        if(it != costs.end()) return it->second;
+        Environment at = env;
+        at.d = 0;
+        long long intercept = getCost(name, at);
+        at.d = 1;
+        long long slope = getCost(name, at) - intercept;
+        at.d = 2;
+        assert(getCost(name, at) == intercept + 2*slope); // cost must be affine in d
+        return costs[name] = {intercept, slope};
+    };
+
+    // a gate's parents are the previous gates on its qubits, so tracking when each qubit becomes free
+    // is the same longest-path recurrence as in criticalPath(), but needs no per-gate storage
+    std::vector<long long> free (static_cast<std::size_t>(circuit.numLogicalQubits())*numDistances, 0);
+    std::vector<long long> length (numDistances, 0);
+    for(int id = 0; id < circuit.numGates(); ++id) {
+        const Gate& g = circuit.get(id);
+        const AffineCost& cost = getAffineCost(g.name);
+        long long* target = &free[static_cast<std::size_t>(g.target)*numDistances];
+        long long* control = isSingle(g) ? target : &free[static_cast<std::size_t>(g.control)*numDistances];
+        for(int k = 0; k < numDistances; ++k) {
+            long long finish = std::max(control[k], target[k]) + cost.intercept + cost.slope*distances[k];
+            control[k] = target[k] = finish;
+            length[k] = std::max(length[k], finish);
+        }
+    }
+    return length;
+}
+
+long long criticalPathEventDriven(CircuitDAG& circuit, const Environment& env) {
+    Matrix world (1); // gates take no braiding resources here
+    PathPool paths;
+    ActiveGateQueue activeGates;
+    long long numCycles = 0;
+
+    // start every executable gate, then jump to the next completion and resolve what finished
+    while(!activeGates.empty() || !circuit.getExecutableGates().empty()) {
+        while(!circuit.getExecutableGates().empty()) { // activating a gate removes it from the list
+            int gateId = circuit.getExecutableGates().back();
+            activeGates.push(activateGate(circuit.get(gateId), {}, world, paths, env), numCycles);
+            circuit.activateGate(gateId);
+        }
+
+        numCycles = activeGates.nextCompletion();
+        while(activeGates.hasCompleted(numCycles)) {
+            circuit.resolveGate(activeGates.popCompleted().id);
+        }
+    }
+    circuit.reset();
+    return numCycles;
+}
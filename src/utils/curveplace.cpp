@@ -0,0 +1,126 @@
+#include "curveplace.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+/* ----- private helper functions ----- */
+
+// visits the component of 'source' breadth-first, appending its vertices to 'out'
+// 'seen' holds the stamp of the search that last reached each vertex
+// returns the last vertex reached (one of the farthest from 'source')
+static int visitComponent(
+    const metisGraph& g,
+    int source,
+    int stamp,
+    std::vector<int>& seen,
+    std::vector<int>& out,
+    std::vector<std::pair<idx_t, int>>& neighbours // scratch
+) {
+    std::size_t head = out.size();
+    seen[source] = stamp;
+    out.push_back(source);
+    while(head < out.size()) {
+        int v = out[head++];
+
+        // heavier edges first, then lower degree (as in Cuthill-McKee), then lower index
+        neighbours.clear();
+        for(idx_t e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+            int u = g.adjncy[e];
+            if(seen[u] != stamp) neighbours.push_back({g.adjwgt.empty() ? 1 : g.adjwgt[e], u});
+        }
+        std::sort(neighbours.begin(), neighbours.end(), [&](const auto& a, const auto& b) {
+            if(a.first != b.first) return a.first > b.first;
+            idx_t degreeA = g.xadj[a.second+1] - g.xadj[a.second];
+            idx_t degreeB = g.xadj[b.second+1] - g.xadj[b.second];
+            if(degreeA != degreeB) return degreeA < degreeB;
+            return a.second < b.second;
+        });
+        for(const auto& n : neighbours) {
+            if(seen[n.second] == stamp) continue; // parallel edges are merged, but be safe
+            seen[n.second] = stamp;
+            out.push_back(n.second);
+        }
+    }
+    return out.back();
+}
+
+/* ----- header function implementations ----- */
+
+std::vector<int> bfsOrder(const metisGraph& g) {
+    int n = g.xadj.size() - 1;
+    std::vector<int> order, isolated, sweep;
+    std::vector<int> seen (n, 0);
+    std::vector<std::pair<idx_t, int>> neighbours;
+    order.reserve(n);
+    int stamp = 0;
+
+    for(int v = 0; v < n; ++v) {
+        if(seen[v] != 0) continue;
+        if(g.xadj[v+1] == g.xadj[v]) {
+            seen[v] = -1;
+            isolated.push_back(v);
+            continue;
+        }
+
+        // find a pseudo-peripheral vertex: start from the lowest degree vertex of the component,
+        // then move to the farthest vertex of a search from there
+        sweep.clear();
+        visitComponent(g, v, ++stamp, seen, sweep, neighbours);
+        int source = *std::min_element(sweep.begin(), sweep.end(), [&](int a, int b) {
+            idx_t degreeA = g.xadj[a+1] - g.xadj[a];
+            idx_t degreeB = g.xadj[b+1] - g.xadj[b];
+            return (degreeA != degreeB) ? degreeA < degreeB : a < b;
+        });
+        sweep.clear();
+        source = visitComponent(g, source, ++stamp, seen, sweep, neighbours);
+
+        visitComponent(g, source, ++stamp, seen, order, neighbours);
+    }
+
+    order.insert(order.end(), isolated.begin(), isolated.end());
+    assert(static_cast<int>(order.size()) == n);
+    return order;
+}
+
+std::vector<Cell> hilbertCurve(int length) {
+    int side = 1;
+    while(side < length) side <<= 1;
+
+    std::vector<Cell> curve;
+    curve.reserve(length*length);
+    for(long long d = 0; d < static_cast<long long>(side)*side; ++d) {
+        // convert distance along the curve to a cell, one quadrant level at a time
+        int x = 0, y = 0;
+        long long t = d;
+        for(int s = 1; s < side; s <<= 1) {
+            int rx = 1 & (t >> 1);
+            int ry = 1 & (t ^ rx);
+            if(ry == 0) { // rotate the quadrant
+                if(rx == 1) {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+                std::swap(x, y);
+            }
+            x += s*rx;
+            y += s*ry;
+            t >>= 2;
+        }
+        if(x < length && y < length) curve.push_back({x, y});
+    }
+    return curve;
+}
+
+std::vector<int> curvePlacement(const metisGraph& coupling, const Lattice& grid) {
+    std::vector<int> order = bfsOrder(coupling);
+    std::vector<Cell> curve = hilbertCurve(grid.latticeLength());
+    assert(order.size() <= curve.size());
+
+    // spread the qubits evenly along the curve, so free cells are left between them for braiding
+    std::vector<int> map (order.size());
+    for(std::size_t i = 0; i < order.size(); ++i) {
+        std::size_t position = i*curve.size()/order.size();
+        map[coupling.id_map[order[i]]] = grid.getPhysQubitNumber(curve[position]);
+    }
+    return map;
+}
@@ -1,46 +1,88 @@
 #include "findswaps.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <thread>
 #include "setutils.hpp"
 #include "graphutils.hpp"
 #include "pathfind.hpp"
+#include "parallel.hpp"
 
 /* ----- private helper functions ----- */
 
-// see if the new swap gate can be scheduled w/o a braiding resource conflict
-// returns number of vertices used, of -1 if braiding conflict occurs
-// takes 'stk' and 'world' by copy
-int canSchedule(std::stack<Gate> stk, const Gate& newSwap, const Lattice& grid, Matrix world) {
-    int numVertices = 0;
-    stk.push(newSwap);
-    while(!stk.empty()) {
-        Gate swap = stk.top();
-        stk.pop();
-        std::vector<Point> path = braid(swap, grid, world);
-        if(path.empty()) {
-            return -1;
-        } else {
-            numVertices += path.size();
-            for(const Point& p : path) {
-                assert(world[p] == 0);
-                world[p] = 1;
-            }
+// routes a SWAP layer incrementally: braids of accepted SWAPs stay claimed in a private copy of 'world',
+// and each candidate is braided against them alone (one search per candidate)
+// candidates are only read against the claimed lattice, so they can be evaluated concurrently
+class SwapRouter {
+public:
+    SwapRouter(const Matrix& world, std::pmr::memory_resource* memory) : claimed(world, memory) {}
+
+    // returns the number of vertices all claimed braids would use if 'swap' were added,
+    // or -1 if braiding conflict occurs
+    // the search state is allocated from 'scratch' (if non-null), which is reset afterwards
+    int evaluate(const Gate& swap, const Lattice& grid, CycleArena* scratch) const {
+        int length = braid(swap, grid, claimed, searchOptions(scratch, scratch)).size();
+        if(scratch) scratch->reset();
+        return length == 0 ? -1 : numVertices + length;
+    }
+
+    // braid 'swap' and keep its path claimed (ie the SWAP is accepted)
+    // returns the number of vertices used by all claimed braids, or -1 if braiding conflict occurs
+    int claim(const Gate& swap, const Lattice& grid, std::pmr::vector<Point>& path, CycleArena* scratch) {
+        path = braid(swap, grid, claimed, searchOptions(path.get_allocator().resource(), scratch));
+        if(scratch) scratch->reset();
+        if(path.empty()) return -1;
+        for(const Point& p : path) {
+            assert(claimed[p] == 0);
+            claimed[p] = 1;
         }
+        numVertices += path.size();
+        return numVertices;
     }
-    return numVertices;
-}
+
+private:
+    Matrix claimed;
+    int numVertices = 0; // vertices claimed by accepted SWAPs
+
+    static SearchOptions searchOptions(std::pmr::memory_resource* memory, CycleArena* scratch) {
+        SearchOptions options;
+        if(memory) options.memory = memory;
+        if(scratch) options.scratch = scratch;
+        return options;
+    }
+};
+
+// a qubit pair that may be swapped, and its score
+struct Candidate {
+    int q1, q2;
+    int numVertices = -1; // vertices used by the SWAP layer if accepted (-1 if it cannot be braided)
+    double interference = 0; // objective after the swap: front layer edges plus weighted window edges
+    double windowDelta = 0; // change in weighted window edges caused by the swap
+
+    Candidate(int q1, int q2) : q1(q1), q2(q2) {}
+};
 
 /* ----- actual function implementations ----- */
 
-int findSwaps(std::vector<Gate> frontLayer, Lattice& grid, const Matrix& world, int& res) {
+int findSwaps(std::vector<Gate>& frontLayer, Lattice& grid, const Matrix& world, int& res, const SwapOptions& options) {
+    const LookaheadWindow* window = options.window;
+    std::pmr::memory_resource* memory = options.memory;
     res = 0; // at first, no resources are used yet
     for(int i = 0; i < frontLayer.size(); ++i) { // relabel gate ids for ease of access (function-local ids)
         assert(!isSingle(frontLayer[i]));
         frontLayer[i].id = i;
     }
 
-    std::stack<Gate> SWAPstack; // stack of SWAP gates scheduled so far
-    std::unordered_set<int> busyQubits; // set of logical qubits participating in a SWAP (in SWAPstack)
+    std::stack<Gate, std::pmr::deque<Gate>> SWAPstack { std::pmr::deque<Gate>(memory) }; // SWAP gates scheduled so far
+    SwapRouter router (world, memory); // holds the braids of SWAPstack
+    std::pmr::unordered_set<int> busyQubits (memory); // set of logical qubits participating in a SWAP (in SWAPstack)
+    if(options.excludedQubits) { // treated as busy from the start
+        busyQubits.insert(options.excludedQubits->begin(), options.excludedQubits->end());
+    }
 
     // predicates to ensure the same (logical) qubit doesn't take part in 2+ SWAPS simultaneously
     auto isFreeQubit = [&](int qubit) -> bool { return !contains(busyQubits, qubit); };
@@ -49,8 +91,30 @@ int findSwaps(std::vector<Gate> frontLayer, Lattice& grid, const Matrix& world,
     };
 
     // interference graph
-    Graph interferenceGraph = buildInterferenceGraph(frontLayer, grid);
-    int interference = std::numeric_limits<int>::max(); // objective we are trying to minimize
+    Graph interferenceGraph = buildInterferenceGraph(frontLayer, grid, memory);
+    double interference = std::numeric_limits<double>::max(); // objective we are trying to minimize
+
+    // weighted interference edges within each upcoming layer (kept up to date as swaps are accepted)
+    double windowInterference = 0;
+    if(window) {
+        for(int i = 0; i < window->numLayers(); ++i) {
+            windowInterference += window->weight(i)*buildInterferenceGraph(window->getLayer(i), grid, memory).numEdges();
+        }
+    }
+
+    // workers that score candidates; started once per call rather than once per accepted swap
+    // (never more than the hardware runs at once: each round only has a handful of short tasks)
+    int numThreads = std::min<int>(options.numThreads, std::max(std::thread::hardware_concurrency(), 1u));
+    std::optional<TaskPool> pool;
+    std::vector<std::unique_ptr<CycleArena>> workerScratch; // search state of workers 1.. (worker 0 is this thread)
+    if(numThreads > 1) {
+        pool.emplace(numThreads);
+        for(int i = 1; i < numThreads; ++i) workerScratch.emplace_back(new CycleArena());
+    }
+    auto scratchOf = [&](int worker) -> CycleArena* {
+        return worker == 0 ? options.scratch : workerScratch[worker - 1].get();
+    };
+    std::pmr::vector<Candidate> candidates (memory);
 
     // enter loop -> schedule as many swaps as possible
     while(true) {
@@ -72,37 +136,63 @@ int findSwaps(std::vector<Gate> frontLayer, Lattice& grid, const Matrix& world,
         int swapqubit1 = -1, swapqubit2 = -1; // placeholders for the chosen swap pair
         Gate newSwap = { -1, "swap", -1, -1 }; // id set to -1 b/c it is not used
 
-        // try each qubit pair combination and see which one is the best
+        // collect each qubit pair combination whose qubits are free
+        candidates.clear();
         for(int q1 : qubits1) {
             for(int q2 : qubits2) {
-                if(!isFreeQubit(q1) || !isFreeQubit(q2)) continue; // make sure qubits are free
-                newSwap.control = q1; newSwap.target = q1;
-                int numVertices = canSchedule(SWAPstack, newSwap, grid, world);
-                if(numVertices == -1) continue; // make sure resources are sufficient
-
-                // test the swap and see if it reduces the objective
-                grid.swapLogicalQubit(q1, q2);
-                interferenceGraph = buildInterferenceGraph(frontLayer, grid);
-                grid.swapLogicalQubit(q1, q2); // swap back to undo the mapping change
-                if(interferenceGraph.numEdges() < interference) {
-                    interference = interferenceGraph.numEdges();
-                    swapqubit1 = q1;
-                    swapqubit2 = q2;
-                    res = numVertices; // update resource utilization metric
+                if(isFreeQubit(q1) && isFreeQubit(q2)) candidates.push_back({ q1, q2 });
+            }
+        }
+
+        // score the candidates (concurrently, if enabled); grid, world and the graph are only read here
+        auto score = [&](Candidate& c, int worker) {
+            Gate trial = { -1, "swap", c.q1, c.q2 };
+            c.numVertices = router.evaluate(trial, grid, scratchOf(worker));
+            if(c.numVertices == -1) return; // make sure resources are sufficient
+            if(window) {
+                for(int l = 0; l < window->numLayers(); ++l) {
+                    c.windowDelta += window->weight(l)*interferenceDelta(window->getLayer(l), grid, c.q1, c.q2);
                 }
             }
+            c.interference = interferenceGraph.numEdges() + interferenceDelta(frontLayer, grid, c.q1, c.q2) +
+                             windowInterference + c.windowDelta;
+        };
+        if(pool && candidates.size() > 1) {
+            for(Candidate& c : candidates) pool->spawn([&score, &c](int worker) { score(c, worker); });
+            pool->wait();
+        } else {
+            for(Candidate& c : candidates) score(c, 0);
+        }
+
+        // see which one is the best (in the same order as a serial evaluation, so the choice is deterministic)
+        double windowDelta = 0;
+        for(const Candidate& c : candidates) {
+            if(c.numVertices == -1) continue;
+            if(c.interference < interference) { // test the swap and see if it reduces the objective
+                interference = c.interference;
+                swapqubit1 = c.q1;
+                swapqubit2 = c.q2;
+                windowDelta = c.windowDelta;
+                res = c.numVertices; // update resource utilization metric
+            }
         }
 
         if(swapqubit1 == -1 || swapqubit2 == -1) break; // no valid swap candidate found
 
         // else, schedule new swap gate, officially alter mapping, and push onto the stack
         newSwap.control = swapqubit1; newSwap.target = swapqubit2;
+        std::pmr::vector<Point> path (memory);
+        int numVertices = router.claim(newSwap, grid, path, options.scratch); // claim the braid of the actual swap
+        if(numVertices == -1) break; // no resources are left for this swap, so do not alter the mapping
         SWAPstack.push(newSwap);
         busyQubits.insert({swapqubit1, swapqubit2}); // mark qubits as busy
         grid.swapLogicalQubit(swapqubit1, swapqubit2);
+        res = numVertices;
+        if(options.braids) options.braids->push_back({ newSwap, std::move(path) });
 
         // update interference graph
-        interferenceGraph = buildInterferenceGraph(frontLayer, grid);
+        updateInterferenceGraph(interferenceGraph, frontLayer, grid, swapqubit1, swapqubit2, memory);
+        windowInterference += windowDelta;
     }
 
     return SWAPstack.size();
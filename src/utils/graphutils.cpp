@@ -9,8 +9,8 @@
 static void backDFS(
     const Graph& g,
     int id,
-    std::vector<int>& cc,
-    std::unordered_set<int>& visited,
+    std::pmr::vector<int>& cc,
+    std::pmr::unordered_set<int>& visited,
     int& edges
 ) {
     visited.insert(id);
@@ -27,8 +27,8 @@ static void backDFS(
 static void forwardDFS(
     const Graph& g,
     int id,
-    std::vector<int>& cc,
-    std::unordered_set<int>& visited,
+    std::pmr::vector<int>& cc,
+    std::pmr::unordered_set<int>& visited,
     int& edges
 ) {
     visited.insert(id);
@@ -43,17 +43,54 @@ static void forwardDFS(
     }
 }
 
+// does the gate act on logical qubits q1 or q2?
+static bool isTouched(const Gate& g, int q1, int q2) {
+    return g.control == q1 || g.control == q2 || g.target == q1 || g.target == q2;
+}
+
+// bounding box of a gate's cells (same convention as Lattice::checkOverlap())
+// as if logical qubits q1 and q2 had swapped places in grid's mapping
+static Box getSwappedBox(const Gate& g, const Lattice& grid, int q1, int q2) {
+    auto position = [&](int q) -> Cell {
+        if(q == q1) return grid.getLatticePosition(q2);
+        if(q == q2) return grid.getLatticePosition(q1);
+        return grid.getLatticePosition(q);
+    };
+    Cell c1 = position(g.control);
+    Cell c2 = position(g.target);
+    return { { std::min(c1.x, c2.x), std::min(c1.y, c2.y) }, { std::max(c1.x, c2.x) + 1, std::max(c1.y, c2.y) + 1 } };
+}
+
+static bool checkOverlap(const Box& b1, const Box& b2) {
+    return b1.lo.x <= b2.hi.x && b2.lo.x <= b1.hi.x && b1.lo.y <= b2.hi.y && b2.lo.y <= b1.hi.y;
+}
+
+// number of interference edges with at least one endpoint acting on logical qubits t1 or t2
+// as if logical qubits q1 and q2 had swapped places (pass q1 == q2 for the current mapping)
+static int countTouchedEdges(const std::vector<Gate>& gates, const Lattice& grid, int t1, int t2, int q1, int q2) {
+    int count = 0;
+    for(int i = 0; i < gates.size(); ++i) {
+        if(!isTouched(gates[i], t1, t2)) continue;
+        Box box = getSwappedBox(gates[i], grid, q1, q2);
+        for(int j = 0; j < gates.size(); ++j) {
+            if(j <= i && isTouched(gates[j], t1, t2)) continue; // pairs of touched gates are counted once
+            if(checkOverlap(box, getSwappedBox(gates[j], grid, q1, q2))) ++count;
+        }
+    }
+    return count;
+}
+
 /* ----- utility function implementations ----- */
 
-std::vector<std::vector<int>> getComponentsInOrder(const Graph& g) {
+std::pmr::vector<std::pmr::vector<int>> getComponentsInOrder(const Graph& g, std::pmr::memory_resource* memory) {
     // will store # edges as last element of each Component (for sorting)
-    using Component = std::vector<int>;
+    using Component = std::pmr::vector<int>;
 
-    std::vector<Component> result;
-    std::unordered_set<int> visited;
+    std::pmr::vector<Component> result (memory);
+    std::pmr::unordered_set<int> visited (memory);
     for(const Graph::Vertex& v : g) {
         if(contains(visited, v.id)) continue;
-        Component cc;
+        Component cc (memory);
         int numEdges = 0; // compute 2m, where m = # edges in component
         switch(v.degree()) {
             case 0:
@@ -84,15 +121,31 @@ std::vector<std::vector<int>> getComponentsInOrder(const Graph& g) {
     return result;
 }
 
-Graph buildInterferenceGraph(const std::vector<Gate>& gates, const Lattice& grid) {
-    Graph interference;
+int interferenceDelta(const std::vector<Gate>& gates, const Lattice& grid, int q1, int q2) {
+    int before = countTouchedEdges(gates, grid, q1, q2, q1, q1);
+    int after = countTouchedEdges(gates, grid, q1, q2, q1, q2);
+    return after - before;
+}
+
+void updateInterferenceGraph(
+    Graph& interference,
+    const std::vector<Gate>& gates,
+    const Lattice& grid,
+    int q1,
+    int q2,
+    std::pmr::memory_resource* memory
+) {
     for(int i = 0; i < gates.size(); ++i) {
-        interference.addVertex(gates[i].id);
-        for(int j = 0; j < i; ++j) {
-            if(grid.checkOverlap(gates[i], gates[j])) {
-                interference.addEdge(gates[i].id, gates[j].id);
-            }
+        if(!isTouched(gates[i], q1, q2)) continue;
+        const Gate& g = gates[i];
+        std::pmr::vector<int> oldNeighbours (
+            interference.getVertex(g.id).neighbours.begin(),
+            interference.getVertex(g.id).neighbours.end(),
+            memory
+        );
+        for(int id : oldNeighbours) interference.deleteEdge(g.id, id);
+        for(int j = 0; j < gates.size(); ++j) {
+            if(j != i && grid.checkOverlap(g, gates[j])) interference.addEdge(g.id, gates[j].id);
         }
     }
-    return interference;
-}
\ No newline at end of file
+}
@@ -0,0 +1,90 @@
+#include "parallel.hpp"
+
+// index of the worker the current thread acts as, and the pool it belongs to
+static thread_local const TaskPool* currentPool = nullptr;
+static thread_local int currentWorker = 0;
+
+TaskPool::TaskPool(int numThreads) : numPending(0), numQueued(0), isStopping(false), numSleeping(0) {
+    numThreads = std::max(numThreads, 1);
+    for(int i = 0; i < numThreads; ++i) queues.emplace_back(new Queue());
+    for(int i = 1; i < numThreads; ++i) threads.emplace_back(&TaskPool::workerLoop, this, i);
+}
+
+TaskPool::~TaskPool() {
+    isStopping = true;
+    wakeAll();
+    for(std::thread& t : threads) t.join();
+}
+
+void TaskPool::spawn(Task task) {
+    int self = (currentPool == this) ? currentWorker : 0;
+    ++numPending;
+    {
+        std::lock_guard<std::mutex> guard (queues[self]->lock);
+        queues[self]->tasks.push_back(std::move(task));
+    }
+    ++numQueued;
+    wakeAll();
+}
+
+void TaskPool::wait() {
+    const TaskPool* oldPool = currentPool;
+    int oldWorker = currentWorker;
+    currentPool = this;
+    currentWorker = 0;
+    while(numPending > 0) {
+        if(!runOne(0)) sleepUntil(&TaskPool::isDoneOrQueued);
+    }
+    currentPool = oldPool;
+    currentWorker = oldWorker;
+}
+
+bool TaskPool::runOne(int self) {
+    Task task;
+
+    // newest own task first, then the oldest task of the other workers
+    {
+        std::lock_guard<std::mutex> guard (queues[self]->lock);
+        if(!queues[self]->tasks.empty()) {
+            task = std::move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+        }
+    }
+    for(int i = 1; !task && i < numWorkers(); ++i) {
+        Queue& victim = *queues[(self + i) % numWorkers()];
+        std::lock_guard<std::mutex> guard (victim.lock);
+        if(!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+    if(!task) return false;
+
+    --numQueued;
+    task(self);
+    if(--numPending == 0) wakeAll(); // wait() may be asleep
+    return true;
+}
+
+void TaskPool::workerLoop(int self) {
+    currentPool = this;
+    currentWorker = self;
+    while(!isStopping) {
+        if(!runOne(self)) sleepUntil(&TaskPool::hasQueuedTasks);
+    }
+}
+
+void TaskPool::sleepUntil(bool (TaskPool::*isReady)() const) {
+    // a waker changes the counters before reading numSleeping, and a sleeper counts itself before
+    // checking them, so either the waker sees the sleeper or the sleeper sees the change
+    std::unique_lock<std::mutex> guard (idleLock);
+    ++numSleeping;
+    idle.wait(guard, [&]() { return (this->*isReady)(); });
+    --numSleeping;
+}
+
+void TaskPool::wakeAll() {
+    if(numSleeping == 0) return;
+    std::lock_guard<std::mutex> guard (idleLock);
+    idle.notify_all();
+}
@@ -4,6 +4,9 @@
 #include <array>
 #include <unordered_map>
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "parallel.hpp"
 
 /* ----- private helper functions and metis parameters ----- */
 
@@ -11,17 +14,79 @@ using Range = std::array<int, 2>; // represents the interval [arr0, arr1)
 
 static idx_t options[METIS_NOPTIONS];
 
+// the coupling graph in CSR form plus scratch space shared by all levels of the recursion
+// subgraphs are index ranges of 'order' (a permutation of the vertices); their CSR arrays are
+// extracted into scratch buffers, which are allocated once for the whole graph
+// concurrent sub-bisections work on disjoint ranges of 'order', and each worker of the task pool
+// has its own scratch buffers
+struct Bisection {
+    // scratch space for the subgraph being split
+    struct Scratch {
+        std::vector<idx_t> local; // index of each vertex within the subgraph (-1 if not in it)
+        std::vector<idx_t> xadj, adjncy, adjwgt, partition;
+        std::vector<int> side2; // vertices moved behind the first half while partitioning 'order'
+    };
+
+    metisGraph graph; // whole coupling graph
+    std::vector<int> order; // vertex indices; each subgraph is a contiguous range of it
+    std::vector<Scratch> scratch; // one per worker
+
+    TaskPool* pool = nullptr; // null for serial placement
+    int taskDepth = 0; // recursion levels that spawn tasks
+
+    Bisection(metisGraph g, int numWorkers) : graph(std::move(g)), scratch(numWorkers) {
+        int n = graph.id_map.size();
+        order.resize(n);
+        for(int i = 0; i < n; ++i) order[i] = i;
+        for(Scratch& s : scratch) {
+            s.local.assign(n, -1);
+            s.xadj.reserve(n + 1);
+            s.adjncy.reserve(graph.adjncy.size());
+            s.adjwgt.reserve(graph.adjwgt.size());
+            s.partition.reserve(n);
+            s.side2.reserve(n);
+        }
+    }
+
+    // fill the scratch CSR arrays with the subgraph induced by order[begin, end)
+    // vertices and adjacency lists keep their relative order in the whole graph
+    void extract(Scratch& s, int begin, int end) {
+        for(int i = begin; i < end; ++i) s.local[order[i]] = i - begin;
+        s.xadj.assign(1, 0);
+        s.adjncy.clear();
+        s.adjwgt.clear();
+        for(int i = begin; i < end; ++i) {
+            int v = order[i];
+            for(idx_t e = graph.xadj[v]; e < graph.xadj[v+1]; ++e) {
+                idx_t u = s.local[graph.adjncy[e]];
+                if(u == -1) continue;
+                s.adjncy.push_back(u);
+                if(!graph.adjwgt.empty()) s.adjwgt.push_back(graph.adjwgt[e]);
+            }
+            s.xadj.push_back(s.adjncy.size());
+        }
+        for(int i = begin; i < end; ++i) s.local[order[i]] = -1;
+    }
+};
+
 // recursive helper function called by initialPlacement()
+// places the vertices in order[begin, end)
+// both halves write to disjoint entries of 'map', so the result does not depend on which
+// worker runs which half, or when
 static void initPlacementInner(
     std::vector<int>& map,
-    const Graph& cp,
+    Bisection& b,
+    int worker, // index of the task pool worker running this call (0 if serial)
+    int depth, // recursion level
+    int begin,
+    int end,
     const Lattice& grid,
     const Range& split, // the interval that will be halved
     const Range& keep, // the interval that is kept the same
     bool splitX // is 'split' an x-axis interval? (else it is a y-axis interval)
 ) {
     // test base condition ( <= 2 vertices to place )
-    if(cp.numVertices() <= 2) {
+    if(end - begin <= 2) {
         const Range& xRange = (splitX)? split : keep;
         const Range& yRange = (splitX)? keep : split;
 
@@ -29,12 +94,12 @@ static void initPlacementInner(
         assert(xRange[1] > xRange[0] && yRange[1] > yRange[0]);
 
         // arbitrarily place remaining logical qubits
-        auto vptr = cp.begin();
+        int next = begin;
         for(int x = xRange[0]; x < xRange[1]; ++x) {
             for(int y = yRange[0]; y < yRange[1]; ++y) {
-                if(vptr == cp.end()) break;
-                map[vptr->id] = grid.getPhysQubitNumber({x, y});
-                ++vptr;
+                if(next == end) break;
+                map[b.graph.id_map[b.order[next]]] = grid.getPhysQubitNumber({x, y});
+                ++next;
             }
         }
         return;
@@ -47,29 +112,30 @@ static void initPlacementInner(
     int area2 = (half2[1] - half2[0])*(keep[1] - keep[0]);
     real_t totalArea = area1 + area2;
 
-    // convert graph to CSR format used by metis
-    auto mg = convert2metisGraph(cp);
+    // extract subgraph in CSR format used by metis
+    Bisection::Scratch& s = b.scratch[worker];
+    b.extract(s, begin, end);
 
     // set up and execute graph partition
-    idx_t nvtxs = cp.numVertices();
+    idx_t nvtxs = end - begin;
     idx_t ncon = 1;
     idx_t nparts = 2; // partition into two halves
     std::array<real_t, 2> tpwgts = { area1/totalArea, area2/totalArea };
     idx_t edgecut;
-    std::vector<idx_t> partition (nvtxs);
+    s.partition.resize(nvtxs);
     int status = METIS_PartGraphRecursive(
         &nvtxs, &ncon,
-        mg.xadj.data(), mg.adjncy.data(),
-        NULL, NULL, NULL,
+        s.xadj.data(), s.adjncy.data(),
+        NULL, NULL, s.adjwgt.empty() ? NULL : s.adjwgt.data(),
         &nparts, tpwgts.data(),
         NULL, options,
         &edgecut,
-        partition.data()
+        s.partition.data()
     );
     assert(status == METIS_OK);
 
     // calculate sizes of the returned partitions
-    int size1 = std::count_if(partition.begin(), partition.end(), [](idx_t x) { return x == 0; });
+    int size1 = std::count_if(s.partition.begin(), s.partition.end(), [](idx_t x) { return x == 0; });
     int size2 = nvtxs - size1;
 
     // redistribute vertices, if necessary (ie adjust partition sizes)
@@ -82,23 +148,36 @@ static void initPlacementInner(
         ++size1;
     }
 
-    // create subgraphs by deleting vertices not belonging to their corresponding partition
-    Graph subcp1 = cp;
-    Graph subcp2 = cp;
-    idx_t index = 0;
-    while(subcp1.numVertices() > size1 && subcp2.numVertices() > size2) {
-        int actualIndex = mg.id_map[index];
-        if(partition[index] == 0) subcp2.deleteVertex(actualIndex);
-        else subcp1.deleteVertex(actualIndex);
-        ++index;
+    // assign vertices to halves in order, following the partition until one half is full;
+    // the remaining vertices fill up the second half first, then the first half
+    // the first half is compacted in place, the second half goes through the scratch buffer
+    int count1 = 0, count2 = 0;
+    s.side2.clear();
+    for(int i = 0; i < nvtxs; ++i) {
+        bool isFirst;
+        if(count1 < size1 && count2 < size2) isFirst = (s.partition[i] == 0);
+        else isFirst = (count2 == size2);
+        if(isFirst) b.order[begin + count1++] = b.order[begin + i];
+        else {
+            s.side2.push_back(b.order[begin + i]);
+            ++count2;
+        }
     }
-    // redistribute vertices, if necessary
-    while(subcp1.numVertices() > size1) subcp1.deleteVertex(mg.id_map[index++]);
-    while(subcp2.numVertices() > size2) subcp2.deleteVertex(mg.id_map[index++]);
-    
+    std::copy(s.side2.begin(), s.side2.end(), b.order.begin() + begin + size1);
+
     // recursively split partitions further
-    initPlacementInner(map, subcp1, grid, keep, half1, !splitX);
-    initPlacementInner(map, subcp2, grid, keep, half2, !splitX);
+    // near the root the second half becomes a task that an idle worker can steal; deeper
+    // subproblems are too small to be worth the overhead and are split serially
+    int mid = begin + size1;
+    if(b.pool && depth < b.taskDepth) {
+        b.pool->spawn([&map, &b, depth, mid, end, &grid, keep, half2, splitX](int w) {
+            initPlacementInner(map, b, w, depth + 1, mid, end, grid, keep, half2, !splitX);
+        });
+        initPlacementInner(map, b, worker, depth + 1, begin, mid, grid, keep, half1, !splitX);
+        return;
+    }
+    initPlacementInner(map, b, worker, depth + 1, begin, mid, grid, keep, half1, !splitX);
+    initPlacementInner(map, b, worker, depth + 1, mid, end, grid, keep, half2, !splitX);
 }
 
 /* ----- header function implementations ----- */
@@ -132,6 +211,70 @@ metisGraph convert2metisGraph(const Graph& g) {
     return out;
 }
 
+Graph buildCouplingGraph(const CircuitDAG& circuit) {
+    Graph coupling;
+    for(int i = 0; i < circuit.numLogicalQubits(); ++i) coupling.addVertex(i);
+    for(int id = 0; id < circuit.numGates(); ++id) {
+        const Gate& g = circuit.get(id);
+        if(!isSingle(g)) coupling.addEdge(g.control, g.target);
+    }
+    return coupling;
+}
+
+metisGraph buildWeightedCouplingGraph(const CircuitDAG& circuit, double decay) {
+    static constexpr double resolution = 16; // metis weights are integers; one undecayed gate weighs this much
+
+    // accumulate the weight of every interacting pair, keyed by (smaller qubit, larger qubit)
+    std::unordered_map<long long, double> pairWeights;
+    int n = circuit.numGates();
+    double logDecay = log(decay);
+    for(int id = 0; id < n; ++id) {
+        const Gate& g = circuit.get(id);
+        if(isSingle(g)) continue;
+        long long a = std::min(g.control, g.target), c = std::max(g.control, g.target);
+        pairWeights[(a << 32) | c] += (decay == 1) ? 1 : exp(logDecay*id/n);
+    }
+
+    // gather adjacency lists (sorted by neighbour, so the graph does not depend on hash order)
+    int numQubits = circuit.numLogicalQubits();
+    std::vector<std::vector<std::pair<idx_t, idx_t>>> adjacent (numQubits);
+    for(const auto& entry : pairWeights) {
+        int a = entry.first >> 32, c = entry.first & 0xffffffff;
+        idx_t w = std::max<idx_t>(1, lround(entry.second*resolution));
+        adjacent[a].push_back({c, w});
+        adjacent[c].push_back({a, w});
+    }
+
+    metisGraph out;
+    out.xadj.reserve(numQubits + 1);
+    out.adjncy.reserve(2*pairWeights.size());
+    out.adjwgt.reserve(2*pairWeights.size());
+    out.id_map.reserve(numQubits);
+    out.xadj.push_back(0);
+    for(int v = 0; v < numQubits; ++v) {
+        std::sort(adjacent[v].begin(), adjacent[v].end());
+        for(const auto& edge : adjacent[v]) {
+            out.adjncy.push_back(edge.first);
+            out.adjwgt.push_back(edge.second);
+        }
+        out.xadj.push_back(out.adjncy.size());
+        out.id_map.push_back(v);
+    }
+    return out;
+}
+
+long long couplingCost(const CircuitDAG& circuit, const Lattice& grid) {
+    long long cost = 0;
+    for(int id = 0; id < circuit.numGates(); ++id) {
+        const Gate& g = circuit.get(id);
+        if(isSingle(g)) continue;
+        Cell c = grid.getLatticePosition(g.control);
+        Cell t = grid.getLatticePosition(g.target);
+        cost += abs(c.x - t.x) + abs(c.y - t.y);
+    }
+    return cost;
+}
+
 void initMetisOptions() {
     options[METIS_OPTION_CTYPE] = METIS_CTYPE_SHEM;
     options[METIS_OPTION_IPTYPE] = METIS_IPTYPE_GROW;
@@ -144,9 +287,32 @@ void initMetisOptions() {
     options[METIS_OPTION_DBGLVL] = 0;
 }
 
-std::vector<int> initialPlacement(const Graph& coupling, const Lattice& grid) {
-    assert(coupling.numVertices() <= grid.latticeLength()*grid.latticeLength());
-    std::vector<int> map (coupling.numVertices());
-    initPlacementInner(map, coupling, grid, {0, grid.latticeLength()}, {0, grid.latticeLength()}, true);
+std::vector<int> initialPlacement(const Graph& coupling, const Lattice& grid, int numThreads) {
+    return initialPlacement(convert2metisGraph(coupling), grid, numThreads);
+}
+
+std::vector<int> initialPlacement(const metisGraph& coupling, const Lattice& grid, int numThreads) {
+    int numVertices = coupling.id_map.size();
+    assert(numVertices <= grid.latticeLength()*grid.latticeLength());
+    std::vector<int> map (numVertices);
+    numThreads = std::max(numThreads, 1);
+    Bisection b (coupling, numThreads);
+    auto placeAll = [&](int worker) {
+        initPlacementInner(
+            map, b, worker, 0, 0, numVertices,
+            grid, {0, grid.latticeLength()}, {0, grid.latticeLength()}, true
+        );
+    };
+    if(numThreads == 1) {
+        placeAll(0);
+        return map;
+    }
+
+    // spawn tasks down to about four per worker, leaving room for stealing to balance uneven halves
+    TaskPool pool (numThreads);
+    b.pool = &pool;
+    while((1 << b.taskDepth) < 4*numThreads) ++b.taskDepth;
+    pool.spawn(placeAll);
+    pool.wait();
     return map;
 }
\ No newline at end of file
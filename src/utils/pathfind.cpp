@@ -1,19 +1,33 @@
 #include "pathfind.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
+
+/* ----- search statistics ----- */
+
+static std::atomic<unsigned long> searchCount (0);
+static std::atomic<unsigned long> expansionCount (0);
+
+unsigned long numSearches() { return searchCount; }
+unsigned long numExpansions() { return expansionCount; }
+
+/* ----- pathfinding functions ----- */
 
 // tries pathfind() on all starting points
-std::vector<Point> braid(const Gate& g, const Lattice& grid, const Matrix& world) {
+std::pmr::vector<Point> braid(const Gate& g, const Lattice& grid, const Matrix& world, const SearchOptions& options) {
     static const Point corners[4] = {{0,0}, {0,1}, {1,0}, {1,1}};
 
     Cell source = grid.getLatticePosition(g.control);
     Cell dest = grid.getLatticePosition(g.target);
 
+    if(options.explored) *options.explored = { source, source };
+
     int shortestDist = std::numeric_limits<int>::max();
-    std::vector<Point> path;
+    std::pmr::vector<Point> path (options.memory);
     for(const Point& p : corners) { // try each corner
         Point start = source + p;
-        auto tempPath = pathfind(start, dest, world); // perform A* search
+        auto tempPath = pathfind(start, dest, world, options); // perform A* search
         if(tempPath.size() == 0) continue; // no path found
 
         if(tempPath.size() < shortestDist) {
@@ -24,82 +38,166 @@ std::vector<Point> braid(const Gate& g, const Lattice& grid, const Matrix& world
     return path;
 }
 
-// Matrix 'world' is copied by value b/c it is also used to store path traceback info.
+std::pmr::vector<Point> braidWindowed(
+    const Gate& g,
+    const Lattice& grid,
+    const Matrix& world,
+    int margin,
+    const SearchOptions& options
+) {
+    Cell source = grid.getLatticePosition(g.control);
+    Cell dest = grid.getLatticePosition(g.target);
+    Point maxVertex = { world.numCols() - 1, world.numRows() - 1 };
+
+    while(true) {
+        // bounding box of both cells' corners, grown by the margin and clamped to the lattice
+        Box window = {
+            { std::max(std::min(source.x, dest.x) - margin, 0), std::max(std::min(source.y, dest.y) - margin, 0) },
+            { std::min(std::max(source.x, dest.x) + 1 + margin, maxVertex.x),
+              std::min(std::max(source.y, dest.y) + 1 + margin, maxVertex.y) }
+        };
+        bool isFull = window.lo.x == 0 && window.lo.y == 0 && window.hi.x == maxVertex.x && window.hi.y == maxVertex.y;
+
+        Box searched;
+        SearchOptions windowOptions = options;
+        windowOptions.explored = &searched;
+        windowOptions.window = &window;
+        std::pmr::vector<Point> path = braid(g, grid, world, windowOptions);
+        if(options.explored) *options.explored = searched;
+        if(!path.empty() || isFull) return path;
+
+        // if the failed searches never looked past the window's edge, a wider window cannot help
+        bool isClipped = (searched.lo.x < window.lo.x && window.lo.x > 0) ||
+                         (searched.lo.y < window.lo.y && window.lo.y > 0) ||
+                         (searched.hi.x > window.hi.x && window.hi.x < maxVertex.x) ||
+                         (searched.hi.y > window.hi.y && window.hi.y < maxVertex.y);
+        if(!isClipped) return path;
+        margin *= 2;
+    }
+}
+
 // the heuristic cost function used must be consistent.
-std::vector<Point> pathfind(const Point& start, const Cell& dest, Matrix world) {
+std::pmr::vector<Point> pathfind(const Point& start, const Cell& dest, const Matrix& obstacles, const SearchOptions& options) {
+    // fringe entry; the point is kept alongside its index for the heuristic and bounds checks
+    struct Node {
+        int idx;
+        Point p;
+    };
+
     // functor used to order the fringe
+    // when landmarks are used, heuristic values are cached in 'estimates' as they are costly to compute
     class CompareDist {
     public:
-        CompareDist(const Cell& d, const Matrix& dist) : dest(d), dist(dist) {}
-        bool operator()(const Point& p1, const Point& p2) {
-            if(dist[p1]+manhattan(p1, dest) != dist[p2]+manhattan(p2, dest))
-                return dist[p1]+manhattan(p1, dest) > dist[p2]+manhattan(p2, dest);
+        CompareDist(const Cell& d, const Matrix& dist, const Matrix* estimates) :
+            dest(d), dist(dist), estimates(estimates) {}
+        int heuristic(const Node& n) const { return estimates ? estimates->at(n.idx) : manhattan(n.p, dest); }
+        bool operator()(const Node& n1, const Node& n2) {
+            int f1 = dist.at(n1.idx) + heuristic(n1);
+            int f2 = dist.at(n2.idx) + heuristic(n2);
+            if(f1 != f2)
+                return f1 > f2;
             else
-                return dist[p1] < dist[p2];
+                return dist.at(n1.idx) < dist.at(n2.idx);
         }
 
     private:
         Cell dest;
         const Matrix& dist;
+        const Matrix* estimates;
     };
 
-    // stores directions to expand search in
-    static const Point directions[4] = {{-1,0}, {0,-1}, {1,0}, {0,1}};
-    static const Point inverseDirections[4] = {{1,0}, {0,1}, {-1,0}, {0,-1}};
-
-    std::vector<Point> path;
-    if(world[start] != 0) return path; // shortcut check
+    Box* explored = options.explored;
+    const Landmarks* landmarks = options.landmarks;
+
+    std::pmr::memory_resource* scratch = options.scratch;
+    std::pmr::vector<Point> path (options.memory);
+    if(explored) extend(*explored, start);
+    if(obstacles[start] != 0) return path; // shortcut check
+
+    // 'world' is a copy of the obstacles b/c it is also used to store path traceback info
+    Matrix world (obstacles, scratch);
+    // the border acts as an obstacle, so only a search window needs explicit bounds checks
+    world.setBorder(-1);
+    const Box* bounds = options.window;
+    unsigned long expansions = 0;
+
+    // ALT estimates (only allocated when landmarks are used)
+    // pruning relies on the free space the landmarks were computed over, so a search that prunes
+    // has effectively looked at the whole lattice
+    Matrix estimates (landmarks ? world.numRows() : 0, landmarks ? world.numCols() : 0, scratch);
+    auto estimate = [&](const Node& n) -> int {
+        int h = landmarks->estimate(n.p, dest);
+        if(h != Landmarks::unreachable) h = std::max(h, manhattan(n.p, dest));
+        else if(explored) *explored = { {0, 0}, {world.numCols() - 1, world.numRows() - 1} };
+        estimates.at(n.idx) = h;
+        return h;
+    };
+    Node first = { world.index(start), start };
+    if(landmarks && estimate(first) == Landmarks::unreachable) return path; // destination cannot be reached
 
-    Matrix dist (world.numRows(), world.numCols()); // tracks best distance found so far
+    Matrix dist (world.numRows(), world.numCols(), scratch); // tracks best distance found so far
     bool dirty = false; // tracks if fringe has been updated and needs to be heapified again
-    CompareDist comp (dest, dist);
-    std::vector<Point> fringe;
+    CompareDist comp (dest, dist, landmarks ? &estimates : nullptr);
+    std::pmr::vector<Node> fringe (scratch);
 
     bool found = false;
-    Point final; // stores final goal node, if a path is found
+    Node final; // stores final goal node, if a path is found
 
-    dist[start] = 1;
-    fringe.push_back(start);
+    dist.at(first.idx) = 1;
+    fringe.push_back(first);
     while(!fringe.empty()) {
         std::pop_heap(fringe.begin(), fringe.end(), comp);
-        Point current = fringe.back();
+        Node current = fringe.back();
         fringe.pop_back();
+        ++expansions;
+
+        // expanded vertices and their neighbours (ie a 1-vertex margin) count as explored
+        if(explored) {
+            extend(*explored, current.p + Point{-1,-1});
+            extend(*explored, current.p + Point{1,1});
+        }
 
         // check if current is a goal node
-        if(manhattan(current, dest) == 0) {
+        if(manhattan(current.p, dest) == 0) {
             found = true;
             final = current;
             break;
         }
 
         // parse neighbours and add them to fringe, if necessary
+        int newDist = dist.at(current.idx) + 1; // tentative distance to reach current's neighbours
         for(int i = 0; i < 4; ++i) {
-            Point next = current + directions[i];
-            int newDist = dist[current] + 1; // tentative distance to reach current's neighbours
+            Node next = { world.neighbour(current.idx, i), current.p + Matrix::directions[i] };
 
-            // check the new point is in bounds
-            if(next.x < 0 || next.x >= world.numCols() || next.y < 0 || next.y >= world.numRows()) {
+            // check the new point is in bounds (ie inside the search window)
+            if(bounds && (next.p.x < bounds->lo.x || next.p.x > bounds->hi.x ||
+                          next.p.y < bounds->lo.y || next.p.y > bounds->hi.y)) {
                 continue;
             }
 
             // check if the new point is taken/is an obstacle
-            if(world[next] != 0 && dist[next] == 0) {
+            int& nextDist = dist.at(next.idx);
+            if(world.at(next.idx) != 0 && nextDist == 0) {
                 continue;
             }
 
             // check if the new point is not yet in the fringe
-            if(dist[next] == 0) {
-                dist[next] = newDist;
-                world[next] = i+1; // maintain traceback info
+            if(nextDist == 0) {
+                if(landmarks && estimate(next) == Landmarks::unreachable) { // prune dead ends
+                    nextDist = -1; // never look at this point again
+                    continue;
+                }
+                nextDist = newDist;
+                world.at(next.idx) = i+1; // maintain traceback info
                 fringe.push_back(next);
                 if(!dirty) std::push_heap(fringe.begin(), fringe.end(), comp);
                 continue;
             }
 
             // otherwise, new point is in the fringe; check if update is needed
-            if(dist[next] > newDist) {
-                dist[next] = newDist;
-                world[next] = i+1;
+            if(nextDist > newDist) {
+                nextDist = newDist;
+                world.at(next.idx) = i+1;
                 dirty = true;
             }
         }
@@ -111,13 +209,20 @@ std::vector<Point> pathfind(const Point& start, const Cell& dest, Matrix world)
         }
     }
 
+    ++searchCount;
+    expansionCount += expansions;
+
     if(found) {
-        path.reserve(dist[final]);
-        while(world[final] != 0) { // traceback to get path
-            path.push_back(final);
-            final = final + inverseDirections[world[final]-1];
+        path.reserve(dist.at(final.idx));
+        int idx = final.idx;
+        Point p = final.p;
+        while(world.at(idx) != 0) { // traceback to get path
+            path.push_back(p);
+            int back = Matrix::inverse(world.at(idx)-1);
+            idx = world.neighbour(idx, back);
+            p = p + Matrix::directions[back];
         }
-        path.push_back(final);
+        path.push_back(p);
     }
 
     return path;
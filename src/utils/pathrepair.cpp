@@ -0,0 +1,286 @@
+#include "pathrepair.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include "pathfind.hpp"
+
+/* ----- private helper functions ----- */
+
+static constexpr int INF = std::numeric_limits<int>::max()/2; // leaves room for adding costs
+
+static const Point corners[4] = {{0,0}, {0,1}, {1,0}, {1,1}};
+static const Point directions[4] = {{-1,0}, {0,-1}, {1,0}, {0,1}};
+
+// orders the heap so that the smallest key is at the front
+template<class Entry>
+static bool compareKeys(const Entry& a, const Entry& b) {
+    return (a.k1 != b.k1) ? a.k1 > b.k1 : a.k2 > b.k2;
+}
+
+/* ----- PathRepairer implementation ----- */
+
+PathRepairer::PathRepairer(int rows, int cols, std::size_t memoryBudget) :
+    rows(rows), cols(cols), goal(rows*cols), memoryBudget(memoryBudget) {}
+
+int PathRepairer::heuristic(const SearchState& s, int v) const {
+    if(v == goal) return 0;
+    return manhattan({v%cols, v/cols}, s.dest);
+}
+
+bool PathRepairer::isSource(const SearchState& s, int v) const {
+    int dx = v%cols - s.source.x;
+    int dy = v/cols - s.source.y;
+    return (dx == 0 || dx == 1) && (dy == 0 || dy == 1);
+}
+
+PathRepairer::QueueEntry PathRepairer::calcKey(const SearchState& s, int v) const {
+    int k2 = std::min(s.g[v], s.rhs[v]);
+    return { std::min(k2 + heuristic(s, v), INF), k2, v };
+}
+
+void PathRepairer::updateVertex(SearchState& s, int v, const Matrix& world) {
+    if(v == goal) {
+        // the goal is reached from any corner of the destination cell at no extra cost
+        s.rhs[v] = INF;
+        for(const Point& p : corners) {
+            Point c = s.dest + p;
+            s.rhs[v] = std::min(s.rhs[v], s.g[c.y*cols + c.x]);
+        }
+    } else {
+        Point p = { v%cols, v/cols };
+        if(world[p] != 0) {
+            s.rhs[v] = INF; // obstacles cannot be entered
+        } else {
+            s.rhs[v] = isSource(s, v) ? 1 : INF; // source corners are connected to a virtual start vertex
+            for(const Point& dir : directions) {
+                Point next = p + dir;
+                if(next.x < 0 || next.x >= cols || next.y < 0 || next.y >= rows) continue;
+                s.rhs[v] = std::min(s.rhs[v], s.g[next.y*cols + next.x] + 1);
+            }
+        }
+    }
+
+    // stale heap entries are skipped when popped, so only (re)insertion is needed
+    if(s.g[v] != s.rhs[v]) {
+        s.queue.push_back(calcKey(s, v));
+        std::push_heap(s.queue.begin(), s.queue.end(), compareKeys<QueueEntry>);
+    }
+}
+
+// rebuild the heap from the inconsistent vertices alone, dropping all stale entries
+// each vertex has at most one live entry, so a heap holding more than twice the number of vertices
+// is mostly stale
+void PathRepairer::compactQueue(SearchState& s) {
+    s.queue.clear();
+    for(int v = 0; v <= goal; ++v) {
+        if(s.g[v] != s.rhs[v]) s.queue.push_back(calcKey(s, v));
+    }
+    std::make_heap(s.queue.begin(), s.queue.end(), compareKeys<QueueEntry>);
+    s.queue.shrink_to_fit();
+}
+
+void PathRepairer::computeShortestPath(SearchState& s, const Matrix& world) {
+    auto comp = compareKeys<QueueEntry>;
+    std::size_t maxQueueSize = 2*static_cast<std::size_t>(goal + 1);
+    while(!s.queue.empty()) {
+        if(s.queue.size() > maxQueueSize) compactQueue(s);
+
+        QueueEntry top = s.queue.front();
+        QueueEntry goalKey = calcKey(s, goal);
+        bool isBeforeGoal = comp(goalKey, top); // top key < goal key
+        if(!isBeforeGoal && s.rhs[goal] == s.g[goal]) break;
+
+        std::pop_heap(s.queue.begin(), s.queue.end(), comp);
+        s.queue.pop_back();
+
+        int v = top.v;
+        if(s.g[v] == s.rhs[v]) continue; // already consistent (stale entry)
+        QueueEntry key = calcKey(s, v);
+        if(key.k1 != top.k1 || key.k2 != top.k2) { // stale key: reinsert with the current one
+            s.queue.push_back(key);
+            std::push_heap(s.queue.begin(), s.queue.end(), comp);
+            continue;
+        }
+
+        ++expansions;
+        if(v != goal) {
+            Point p = { v%cols, v/cols };
+            extend(s.touched, p + Point{-1,-1});
+            extend(s.touched, p + Point{1,1});
+        }
+
+        if(s.g[v] > s.rhs[v]) {
+            s.g[v] = s.rhs[v]; // overconsistent: settle vertex
+        } else {
+            s.g[v] = INF; // underconsistent: invalidate vertex and recompute it
+            updateVertex(s, v, world);
+        }
+
+        // update successors
+        if(v == goal) continue;
+        Point p = { v%cols, v/cols };
+        for(const Point& dir : directions) {
+            Point next = p + dir;
+            if(next.x < 0 || next.x >= cols || next.y < 0 || next.y >= rows) continue;
+            updateVertex(s, next.y*cols + next.x, world);
+        }
+        int dx = p.x - s.dest.x;
+        int dy = p.y - s.dest.y;
+        if((dx == 0 || dx == 1) && (dy == 0 || dy == 1)) updateVertex(s, goal, world);
+    }
+}
+
+void PathRepairer::reset(SearchState& s, const Cell& source, const Cell& dest, const Matrix& world) {
+    s.source = source;
+    s.dest = dest;
+    s.g.assign(rows*cols + 1, INF);
+    s.rhs.assign(rows*cols + 1, INF);
+    s.queue.clear();
+    s.touched = { source, source };
+    s.logPos = logBase + changeLog.size();
+    for(const Point& p : corners) {
+        Point c = source + p;
+        updateVertex(s, c.y*cols + c.x, world);
+    }
+    ++freshSearches;
+}
+
+std::pmr::vector<Point> PathRepairer::braid(
+    const Gate& g,
+    const Lattice& grid,
+    const Matrix& world,
+    Box* explored,
+    std::pmr::memory_resource* memory
+) {
+    Cell source = grid.getLatticePosition(g.control);
+    Cell dest = grid.getLatticePosition(g.target);
+
+    // find or create search state
+    auto iter = states.find(g.id);
+    if(iter == states.end()) {
+        lru.push_front(g.id);
+        if(spares.empty()) {
+            iter = states.insert({g.id, SearchState()}).first;
+        } else { // its bytes stay counted until updateUsage() recounts them
+            iter = states.insert({g.id, std::move(spares.back())}).first;
+            spares.pop_back();
+        }
+        iter->second.lruPos = lru.begin();
+        reset(iter->second, source, dest, world);
+    } else {
+        lru.splice(lru.begin(), lru, iter->second.lruPos);
+        SearchState& s = iter->second;
+        std::size_t backlog = logBase + changeLog.size() - s.logPos;
+        bool isMoved = s.source.x != source.x || s.source.y != source.y || s.dest.x != dest.x || s.dest.y != dest.y;
+        if(isMoved || backlog > static_cast<std::size_t>(rows*cols)/2) {
+            reset(s, source, dest, world); // a fresh search is cheaper than repairing
+        } else {
+            // repair: apply all changes made to the lattice since the last search
+            for(std::size_t i = s.logPos - logBase; i < changeLog.size(); ++i) {
+                const Point& p = changeLog[i];
+                updateVertex(s, p.y*cols + p.x, world);
+            }
+            s.logPos = logBase + changeLog.size();
+            ++repairs;
+        }
+    }
+    SearchState& s = iter->second;
+    computeShortestPath(s, world);
+    updateUsage(s);
+    if(explored) *explored = s.touched;
+
+    std::pmr::vector<Point> path (memory);
+    if(s.g[goal] >= INF) return path;
+
+    // traceback from the destination corner reached first
+    int v = -1;
+    for(const Point& p : corners) {
+        Point c = dest + p;
+        if(s.g[c.y*cols + c.x] == s.g[goal]) {
+            v = c.y*cols + c.x;
+            break;
+        }
+    }
+    path.reserve(s.g[goal]);
+    while(true) {
+        Point p = { v%cols, v/cols };
+        path.push_back(p);
+        if(s.g[v] == 1 && isSource(s, v)) break;
+
+        int prev = -1;
+        for(const Point& dir : directions) {
+            Point next = p + dir;
+            if(next.x < 0 || next.x >= cols || next.y < 0 || next.y >= rows) continue;
+            if(world[next] == 0 && s.g[next.y*cols + next.x] == s.g[v] - 1) {
+                prev = next.y*cols + next.x;
+                break;
+            }
+        }
+        assert(prev != -1); // vertices on the shortest path are always consistent
+        v = prev;
+    }
+    return path;
+}
+
+void PathRepairer::forget(int gateId) {
+    auto iter = states.find(gateId);
+    if(iter == states.end()) return;
+    dropState(iter);
+    if(states.empty()) trimLog();
+}
+
+void PathRepairer::updateUsage(SearchState& s) {
+    usedBytes -= s.bytes;
+    s.bytes = (s.g.capacity() + s.rhs.capacity())*sizeof(int) + s.queue.capacity()*sizeof(QueueEntry);
+    usedBytes += s.bytes;
+
+    // free spare buffers first, then evict least recently used states; the most recent one ('s') is always kept
+    while(usedBytes > memoryBudget && (!spares.empty() || lru.size() > 1)) {
+        if(!spares.empty()) {
+            usedBytes -= spares.back().bytes;
+            spares.pop_back();
+        } else {
+            dropState(states.find(lru.back()));
+        }
+    }
+}
+
+std::pmr::unordered_map<int, PathRepairer::SearchState>::iterator PathRepairer::dropState(
+    std::pmr::unordered_map<int, SearchState>::iterator iter
+) {
+    lru.erase(iter->second.lruPos);
+    if(usedBytes <= memoryBudget) {
+        spares.push_back(std::move(iter->second)); // keep its buffers (and their bytes) for the next new state
+    } else {
+        usedBytes -= iter->second.bytes;
+    }
+    return states.erase(iter);
+}
+
+void PathRepairer::notifyChanged(const Point& p) {
+    if(states.empty()) return; // nobody needs to be told
+    changeLog.push_back(p);
+    if(changeLog.size() > static_cast<std::size_t>(rows*cols)) trimLog();
+}
+
+void PathRepairer::notifyCleared() {
+    for(auto iter = states.begin(); iter != states.end();) iter = dropState(iter);
+    trimLog();
+}
+
+// drop states that have fallen too far behind and discard log entries every state has applied
+void PathRepairer::trimLog() {
+    std::size_t end = logBase + changeLog.size();
+    std::size_t minPos = end;
+    for(auto iter = states.begin(); iter != states.end();) {
+        if(end - iter->second.logPos > static_cast<std::size_t>(rows*cols)/2) {
+            iter = dropState(iter); // would be reset anyway
+        } else {
+            minPos = std::min(minPos, iter->second.logPos);
+            ++iter;
+        }
+    }
+    changeLog.erase(changeLog.begin(), changeLog.begin() + (minPos - logBase));
+    logBase = minPos;
+}
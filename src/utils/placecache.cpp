@@ -0,0 +1,190 @@
+#include "placecache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+/* ----- private helper functions ----- */
+
+static const char* header = "autobraid placement cache v2";
+static const char* extension = ".place";
+static const char* temporaryExtension = ".tmp"; // temporary files are named <entry name>.place.<random>.tmp
+
+// 64-bit FNV-1a, fed one integer at a time
+class Hasher {
+public:
+    void add(unsigned long long x) {
+        for(int i = 0; i < 8; ++i) {
+            hash ^= (x >> (8*i)) & 0xff;
+            hash *= 0x100000001b3ULL;
+        }
+    }
+    void add(const std::string& s) {
+        add(s.size());
+        for(unsigned char c : s) add(c);
+    }
+    unsigned long long get() const { return hash; }
+
+private:
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+};
+
+static std::string toHex(unsigned long long x) {
+    char buffer[17];
+    snprintf(buffer, sizeof(buffer), "%016llx", x);
+    return buffer;
+}
+
+// a mapping is valid if it places every qubit on a distinct cell of the lattice
+static bool isValidMapping(const PlacementEntry& entry) {
+    int numCells = entry.key.latticeLength*entry.key.latticeLength;
+    if(static_cast<int>(entry.mapping.size()) != entry.key.numQubits) return false;
+    std::vector<bool> isUsed (numCells, false);
+    for(int phys : entry.mapping) {
+        if(phys < 0 || phys >= numCells || isUsed[phys]) return false;
+        isUsed[phys] = true;
+    }
+    return true;
+}
+
+/* ----- header function implementations ----- */
+
+std::string PlacementKey::name() const {
+    Hasher h;
+    h.add(algorithm);
+    h.add(graphHash);
+    h.add(numQubits);
+    h.add(latticeLength);
+    h.add(options);
+    return toHex(h.get());
+}
+
+bool PlacementKey::operator==(const PlacementKey& other) const {
+    return algorithm == other.algorithm && graphHash == other.graphHash && numQubits == other.numQubits &&
+        latticeLength == other.latticeLength && options == other.options;
+}
+
+unsigned long long hashCouplingGraph(const metisGraph& coupling) {
+    // buildWeightedCouplingGraph() lists every adjacency list sorted by neighbour, so the CSR arrays
+    // are already in canonical order
+    Hasher h;
+    h.add(coupling.id_map.size());
+    for(idx_t x : coupling.xadj) h.add(x);
+    for(idx_t x : coupling.adjncy) h.add(x);
+    for(idx_t x : coupling.adjwgt) h.add(x);
+    return h.get();
+}
+
+PlacementKey makePlacementKey(const metisGraph& coupling, int latticeLength, const Environment& env) {
+    PlacementKey key;
+    key.graphHash = hashCouplingGraph(coupling);
+    key.numQubits = coupling.id_map.size();
+    key.latticeLength = latticeLength;
+
+    // only the options that change the placement (eg not the thread count)
+    std::ostringstream options;
+    if(env.doCurvePlacement) options << "curve";
+    else options << "gpmetis weighted=" << env.doWeightedCoupling;
+    options << " decay=" << env.couplingDecay;
+    if(env.doAnneal) {
+        options << " anneal chains=" << env.annealChains << " sweeps=" << env.annealSweeps
+                << " ms=" << env.annealTimeMs << " seed=" << env.annealSeed;
+    }
+    key.options = options.str();
+    return key;
+}
+
+bool loadPlacement(const std::string& dir, const PlacementKey& key, std::vector<int>& mapping) {
+    PlacementEntry entry;
+    if(!readPlacementEntry((fs::path(dir) / (key.name() + extension)).string(), entry)) return false;
+    if(!(entry.key == key)) return false; // name collision
+    mapping = std::move(entry.mapping);
+    return true;
+}
+
+bool storePlacement(const std::string& dir, const PlacementKey& key, const std::vector<int>& mapping) {
+    std::error_code error;
+    fs::create_directories(dir, error);
+    if(error) return false;
+
+    // write to a temporary file first, so concurrent runs never read a partial entry
+    // (its name is random, so concurrent runs storing the same key never write to the same file)
+    fs::path path = fs::path(dir) / (key.name() + extension);
+    fs::path temporary = path;
+    std::random_device random;
+    temporary += "." + toHex((static_cast<unsigned long long>(random()) << 32) ^ random()) + temporaryExtension;
+    {
+        std::ofstream out (temporary);
+        out << header << '\n';
+        out << "algorithm " << key.algorithm << '\n';
+        out << "graph " << toHex(key.graphHash) << '\n';
+        out << "qubits " << key.numQubits << '\n';
+        out << "length " << key.latticeLength << '\n';
+        out << "options " << key.options << '\n';
+        out << "mapping";
+        for(int phys : mapping) out << ' ' << phys;
+        out << '\n';
+        if(!out) {
+            out.close();
+            fs::remove(temporary, error);
+            return false;
+        }
+    }
+    fs::rename(temporary, path, error);
+    if(!error) return true;
+    fs::remove(temporary, error);
+    return false;
+}
+
+bool readPlacementEntry(const std::string& path, PlacementEntry& entry) {
+    std::ifstream in (path);
+    std::string line, field;
+    if(!std::getline(in, line) || line != header) return false;
+
+    in >> field >> entry.key.algorithm;
+    if(field != "algorithm") return false;
+    in >> field >> std::hex >> entry.key.graphHash >> std::dec;
+    if(field != "graph") return false;
+    in >> field >> entry.key.numQubits;
+    if(field != "qubits") return false;
+    in >> field >> entry.key.latticeLength;
+    if(field != "length") return false;
+    in >> field;
+    if(field != "options") return false;
+    in.get(); // skip the separating space
+    std::getline(in, entry.key.options);
+
+    in >> field;
+    if(field != "mapping") return false;
+    entry.mapping.clear();
+    int phys;
+    while(static_cast<int>(entry.mapping.size()) < entry.key.numQubits && in >> phys) entry.mapping.push_back(phys);
+    return isValidMapping(entry);
+}
+
+std::vector<std::string> listPlacementEntries(const std::string& dir) {
+    std::vector<std::string> paths;
+    std::error_code error;
+    for(fs::directory_iterator it (dir, error), end; !error && it != end; it.increment(error)) {
+        if(it->path().extension() == extension) paths.push_back(it->path().string());
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+std::vector<std::string> listTemporaryFiles(const std::string& dir) {
+    std::vector<std::string> paths;
+    std::error_code error;
+    for(fs::directory_iterator it (dir, error), end; !error && it != end; it.increment(error)) {
+        std::string name = it->path().filename().string();
+        if(it->path().extension() == temporaryExtension && name.find(std::string(extension) + ".") != std::string::npos)
+            paths.push_back(it->path().string());
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
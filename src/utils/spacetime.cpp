@@ -0,0 +1,133 @@
+#include "spacetime.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include "pathfind.hpp"
+
+/* ----- private helper functions ----- */
+
+namespace {
+    // fringe entry; ordered by (start time, estimated length), preferring longer partial paths on ties
+    struct Label {
+        int start; // earliest start time of the partial path (ie latest expiry along it)
+        int f; // length so far + heuristic
+        int dist; // length so far
+        Point p;
+    };
+
+    bool compareLabels(const Label& a, const Label& b) {
+        if(a.start != b.start) return a.start > b.start;
+        if(a.f != b.f) return a.f > b.f;
+        return a.dist < b.dist;
+    }
+}
+
+/* ----- header function implementations ----- */
+
+std::pmr::vector<Point> braidSpaceTime(
+    const Gate& g,
+    const Lattice& grid,
+    const ReservationTable& table,
+    int now,
+    int horizon,
+    int& start,
+    std::pmr::memory_resource* memory,
+    std::pmr::memory_resource* scratch
+) {
+    static const Point corners[4] = {{0,0}, {0,1}, {1,0}, {1,1}};
+    static const Point directions[4] = {{-1,0}, {0,-1}, {1,0}, {0,1}};
+    static const Point inverseDirections[4] = {{1,0}, {0,1}, {-1,0}, {0,-1}};
+
+    Cell source = grid.getLatticePosition(g.control);
+    Cell dest = grid.getLatticePosition(g.target);
+
+    // best (start, dist) label found for each vertex, and traceback info (0 marks a source corner)
+    Matrix bestStart (table.numRows(), table.numCols(), scratch);
+    Matrix bestDist (table.numRows(), table.numCols(), scratch); // 0 means not yet reached
+    Matrix traceback (table.numRows(), table.numCols(), scratch);
+    std::pmr::vector<Label> fringe (scratch);
+
+    auto isBetter = [&](int s, int d, const Point& p) -> bool {
+        return bestDist[p] == 0 || s < bestStart[p] || (s == bestStart[p] && d < bestDist[p]);
+    };
+
+    // searches over vertices free by 'limit'; if 'ignoreStart' is set, every such vertex counts as
+    // free from cycle 0, so the search only minimizes length
+    // returns whether the destination was reached, setting 'final' to the goal vertex
+    auto search = [&](int limit, bool ignoreStart, Point& final) -> bool {
+        fringe.clear();
+        for(const Point& c : corners) {
+            Point p = source + c;
+            int s = std::max(now, table.expiry(p));
+            if(s > limit) continue;
+            if(ignoreStart) s = 0;
+            if(!isBetter(s, 1, p)) continue;
+            bestStart[p] = s;
+            bestDist[p] = 1;
+            fringe.push_back({ s, 1 + manhattan(p, dest), 1, p });
+            std::push_heap(fringe.begin(), fringe.end(), compareLabels);
+        }
+
+        while(!fringe.empty()) {
+            std::pop_heap(fringe.begin(), fringe.end(), compareLabels);
+            Label current = fringe.back();
+            fringe.pop_back();
+
+            // skip stale fringe entries
+            if(current.start != bestStart[current.p] || current.dist != bestDist[current.p]) continue;
+
+            if(manhattan(current.p, dest) == 0) {
+                final = current.p;
+                return true;
+            }
+
+            for(int i = 0; i < 4; ++i) {
+                Point next = current.p + directions[i];
+                if(next.x < 0 || next.x >= table.numCols() || next.y < 0 || next.y >= table.numRows()) {
+                    continue;
+                }
+
+                int s = std::max(current.start, table.expiry(next));
+                int d = current.dist + 1;
+                if(s > limit) continue;
+                if(ignoreStart) s = 0;
+                if(!isBetter(s, d, next)) continue;
+                bestStart[next] = s;
+                bestDist[next] = d;
+                traceback[next] = i+1;
+                fringe.push_back({ s, d + manhattan(next, dest), d, next });
+                std::push_heap(fringe.begin(), fringe.end(), compareLabels);
+            }
+        }
+        return false;
+    };
+
+    std::pmr::vector<Point> path (memory);
+    Point final;
+    if(!search(now + horizon, false, final)) return path;
+    start = bestStart[final];
+
+    // the first pass only guarantees the earliest start: (max, sum) labels are not order-preserving,
+    // so a label that loses on start time at some vertex may have led to a shorter path with the same start
+    // a second, length-only pass over the vertices free by then finds the shortest path with that start
+    // (skipped when the first path already has the length of an unobstructed braid)
+    int shortest = std::numeric_limits<int>::max();
+    for(const Point& c : corners) shortest = std::min(shortest, 1 + manhattan(source + c, dest));
+    if(bestDist[final] > shortest) {
+        clear(bestDist); // marks every vertex unreached; bestStart is only read for reached ones
+        clear(traceback);
+        bool found = search(start, true, final);
+        assert(found); // the first path is still free by then
+        (void)found;
+    }
+
+    path.reserve(bestDist[final]);
+    while(traceback[final] != 0) { // traceback to get path
+        path.push_back(final);
+        final = final + inverseDirections[traceback[final]-1];
+    }
+    path.push_back(final);
+
+    return path;
+}